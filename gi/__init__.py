@@ -20,7 +20,7 @@
 
 from __future__ import absolute_import
 
-from ._gi import _API, Repository
+from ._gi import _API, Repository, get_invoke_stats
 
 # Force loading the GObject typelib so we have available the wrappers for
 # base classes such as GInitiallyUnowned
@@ -53,3 +53,39 @@ def require_version(namespace, version):
 
 def get_required_version(namespace):
     return _versions.get(namespace, None)
+
+_invoke_stats_keys = {
+    'total': lambda r: (r['prepare_time'] + r['invoke_time'] +
+                        r['process_time'] + r['release_time']),
+    'marshal': lambda r: (r['prepare_time'] + r['process_time'] +
+                          r['release_time']),
+    'calls': lambda r: r['calls'],
+    'prepare': lambda r: r['prepare_time'],
+    'invoke': lambda r: r['invoke_time'],
+    'process': lambda r: r['process_time'],
+    'release': lambda r: r['release_time'],
+}
+
+def invoke_stats_report(limit=20, sort='total', reset=False):
+    """Format the functions which took the most time since
+    gi._gi.enable_invoke_stats() was called.
+
+    sort is one of 'total', 'marshal' (the time spent converting
+    arguments both ways and releasing them), 'calls', 'prepare',
+    'invoke', 'process' or 'release'.  Times are in microseconds per call.
+    """
+    key = _invoke_stats_keys[sort]
+    records = sorted(get_invoke_stats(reset), key=key, reverse=True)
+
+    lines = ['%-48s %10s %7s %9s %9s %9s %9s' % (
+             'function', 'calls', 'errors', 'prepare', 'invoke', 'process',
+             'release')]
+    for record in records[:limit]:
+        calls = record['calls']
+        lines.append('%-48s %10d %7d %9.2f %9.2f %9.2f %9.2f' % (
+                     record['name'], calls, record['errors'],
+                     record['prepare_time'] * 1e6 / calls,
+                     record['invoke_time'] * 1e6 / calls,
+                     record['process_time'] * 1e6 / calls,
+                     record['release_time'] * 1e6 / calls))
+    return '\n'.join(lines)
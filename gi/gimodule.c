@@ -482,6 +482,42 @@ _wrap_pyg_variant_type_from_string (PyObject *self, PyObject *args)
     return py_variant;
 }
 
+static PyObject *
+_wrap_pyg_enable_invoke_stats (PyObject *self, PyObject *args)
+{
+    PyObject *py_enable = Py_True;
+    int enable;
+
+    if (!PyArg_ParseTuple (args, "|O:enable_invoke_stats", &py_enable))
+        return NULL;
+
+    enable = PyObject_IsTrue (py_enable);
+    if (enable < 0)
+        return NULL;
+
+    _pygi_invoke_stats_enable (enable);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_get_invoke_stats (PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "reset", NULL };
+    PyObject *py_reset = Py_False;
+    int reset;
+
+    if (!PyArg_ParseTupleAndKeywords (args, kwargs, "|O:get_invoke_stats",
+                                      kwlist, &py_reset))
+        return NULL;
+
+    reset = PyObject_IsTrue (py_reset);
+    if (reset < 0)
+        return NULL;
+
+    return _pygi_invoke_stats_get (reset);
+}
+
 static PyMethodDef _gi_functions[] = {
     { "enum_add", (PyCFunction) _wrap_pyg_enum_add, METH_VARARGS | METH_KEYWORDS },
     { "enum_register_new_gtype_and_add", (PyCFunction) _wrap_pyg_enum_register_new_gtype_and_add, METH_VARARGS | METH_KEYWORDS },
@@ -493,6 +529,8 @@ static PyMethodDef _gi_functions[] = {
     { "hook_up_vfunc_implementation", (PyCFunction) _wrap_pyg_hook_up_vfunc_implementation, METH_VARARGS },
     { "variant_new_tuple", (PyCFunction) _wrap_pyg_variant_new_tuple, METH_VARARGS },
     { "variant_type_from_string", (PyCFunction) _wrap_pyg_variant_type_from_string, METH_VARARGS },
+    { "enable_invoke_stats", (PyCFunction) _wrap_pyg_enable_invoke_stats, METH_VARARGS },
+    { "get_invoke_stats", (PyCFunction) _wrap_pyg_get_invoke_stats, METH_VARARGS | METH_KEYWORDS },
     { NULL, NULL, 0 }
 };
 
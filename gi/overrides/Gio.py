@@ -44,6 +44,50 @@ class FileEnumerator(Gio.FileEnumerator):
     # python 2 compat for the iter protocol
     next = __next__
 
+    def prefetch(self, num_files=100, io_priority=GLib.PRIORITY_DEFAULT,
+                 cancellable=None):
+        """Iterate over the remaining file infos, fetching them num_files
+        at a time.  While the caller works on one batch, the next one is
+        read by next_files_async() in a worker thread.  The results are
+        delivered on a private main context, so no main loop is needed.
+        Infos already fetched are dropped if the iteration stops early.
+        """
+        context = GLib.MainContext.new()
+        results = []
+        in_flight = []
+
+        def on_ready(*args):
+            results.append(args[1])
+
+        def start():
+            context.push_thread_default()
+            try:
+                self.next_files_async(num_files, io_priority, cancellable,
+                                      on_ready, None)
+            finally:
+                context.pop_thread_default()
+            in_flight.append(True)
+
+        def finish():
+            # the GIL is released while waiting here
+            while not results:
+                context.iteration(True)
+            in_flight.pop()
+            return self.next_files_finish(results.pop())
+
+        start()
+        try:
+            while True:
+                batch = finish()
+                if not batch:
+                    return
+                start()
+                for file_info in batch:
+                    yield file_info
+        finally:
+            # the enumerator can't be used while a batch is in flight
+            if in_flight:
+                finish()
 
 FileEnumerator = override(FileEnumerator)
 __all__.append('FileEnumerator')
@@ -694,22 +694,23 @@ class TreeModel(Gtk.TreeModel):
     def __iter__(self):
         return TreeModelRowIter(self, self.get_iter_first())
 
-    def get_iter(self, path):
+    def get_iter(self, path, out=None):
         if not isinstance(path, Gtk.TreePath):
             path = TreePath(path)
 
-        success, aiter = super(TreeModel, self).get_iter(path)
+        success, aiter = super(TreeModel, self).get_iter(path, out=out)
         if not success:
             raise ValueError("invalid tree path '%s'" % path)
         return aiter
 
-    def get_iter_first(self):
-        success, aiter = super(TreeModel, self).get_iter_first()
+    def get_iter_first(self, out=None):
+        success, aiter = super(TreeModel, self).get_iter_first(out=out)
         if success:
             return aiter
 
-    def get_iter_from_string(self, path_string):
-        success, aiter = super(TreeModel, self).get_iter_from_string(path_string)
+    def get_iter_from_string(self, path_string, out=None):
+        success, aiter = super(TreeModel, self).get_iter_from_string(path_string,
+                                                                     out=out)
         if not success:
             raise ValueError("invalid tree path '%s'" % path_string)
         return aiter
@@ -720,18 +721,19 @@ class TreeModel(Gtk.TreeModel):
         if success:
             return next_iter
 
-    def iter_children(self, aiter):
-        success, child_iter = super(TreeModel, self).iter_children(aiter)
+    def iter_children(self, aiter, out=None):
+        success, child_iter = super(TreeModel, self).iter_children(aiter, out=out)
         if success:
             return child_iter
 
-    def iter_nth_child(self, parent, n):
-        success, child_iter = super(TreeModel, self).iter_nth_child(parent, n)
+    def iter_nth_child(self, parent, n, out=None):
+        success, child_iter = super(TreeModel, self).iter_nth_child(parent, n,
+                                                                    out=out)
         if success:
             return child_iter
 
-    def iter_parent(self, aiter):
-        success, parent_iter = super(TreeModel, self).iter_parent(aiter)
+    def iter_parent(self, aiter, out=None):
+        success, parent_iter = super(TreeModel, self).iter_parent(aiter, out=out)
         if success:
             return parent_iter
 
@@ -30,7 +30,8 @@
 static void
 _boxed_dealloc (PyGIBoxed *self)
 {
-    GType g_type;
+    gpointer boxed = ( (PyGBoxed *) self)->boxed;
+    PyGIStructTypeCache *cache;
 
     PyObject_GC_UnTrack ( (PyObject *) self);
 
@@ -38,14 +39,15 @@ _boxed_dealloc (PyGIBoxed *self)
 
     if ( ( (PyGBoxed *) self)->free_on_dealloc) {
         if (self->slice_allocated) {
-            g_slice_free1 (self->size, ( (PyGBoxed *) self)->boxed);
-        } else {
-            g_type = pyg_type_from_object ( (PyObject *) self);
-            g_boxed_free (g_type, ( (PyGBoxed *) self)->boxed);
+            g_slice_free1 (self->size, boxed);
+        } else if (boxed != _pygi_inline_storage (self)) {
+            g_boxed_free ( ( (PyGBoxed *) self)->gtype, boxed);
         }
     }
 
-    Py_TYPE( (PyGObject *) self)->tp_free ( (PyObject *) self);
+    cache = _pygi_struct_type_cache_peek (Py_TYPE (self));
+    _pygi_struct_free ( (PyObject *) self, cache, boxed,
+                        ( (PyGBoxed *) self)->free_on_dealloc);
 }
 
 void *
@@ -86,41 +88,57 @@ _boxed_new (PyTypeObject *type,
 {
     static char *kwlist[] = { NULL };
 
-    GIBaseInfo *info;
-    gsize size = 0;
+    PyGIStructTypeCache *cache;
     gpointer boxed;
-    PyGIBoxed *self = NULL;
+    PyGIBoxed *self;
 
     if (!PyArg_ParseTupleAndKeywords (args, kwargs, "", kwlist)) {
         return NULL;
     }
 
-    info = _pygi_object_get_gi_info ( (PyObject *) type, &PyGIBaseInfo_Type);
-    if (info == NULL) {
-        if (PyErr_ExceptionMatches (PyExc_AttributeError)) {
-            PyErr_Format (PyExc_TypeError, "missing introspection information");
-        }
+    cache = _pygi_struct_type_cache (type, &PyGIBaseInfo_Type);
+    if (cache == NULL) {
         return NULL;
     }
 
-    boxed = _pygi_boxed_alloc (info, &size);
-    if (boxed == NULL) {
+    switch (g_base_info_get_type (cache->info)) {
+        case GI_INFO_TYPE_UNION:
+        case GI_INFO_TYPE_BOXED:
+        case GI_INFO_TYPE_STRUCT:
+            break;
+        default:
+            PyErr_Format (PyExc_TypeError,
+                          "info should be Boxed or Union, not '%d'",
+                          g_base_info_get_type (cache->info));
+            return NULL;
+    }
+
+    /* opaque structures cannot be allocated */
+    if (cache->size == 0) {
         PyErr_NoMemory();
-        goto out;
+        return NULL;
     }
 
+    self = (PyGIBoxed *) _pygi_struct_inline_alloc (type, cache);
+    if (self != NULL) {
+        ( (PyGBoxed *) self)->gtype = cache->g_type;
+        ( (PyGBoxed *) self)->boxed = _pygi_inline_storage (self);
+        ( (PyGBoxed *) self)->free_on_dealloc = TRUE;
+        self->size = cache->size;
+        return (PyObject *) self;
+    }
+
+    boxed = g_slice_alloc0 (cache->size);
+
     self = (PyGIBoxed *) _pygi_boxed_new (type, boxed, TRUE);
     if (self == NULL) {
-        g_slice_free1 (size, boxed);
-        goto out;
+        g_slice_free1 (cache->size, boxed);
+        return NULL;
     }
 
-    self->size = size;
+    self->size = cache->size;
     self->slice_allocated = TRUE;
 
-out:
-    g_base_info_unref (info);
-
     return (PyObject *) self;
 }
 
@@ -133,6 +151,62 @@ _boxed_init (PyObject *self,
     return 0;
 }
 
+static PyObject *
+_boxed_as_tuple (PyObject *self)
+{
+    return _pygi_struct_as_tuple (self, &PyGIBaseInfo_Type);
+}
+
+static PyObject *
+_boxed_as_dict (PyObject *self)
+{
+    return _pygi_struct_as_dict (self, &PyGIBaseInfo_Type);
+}
+
+static PyObject *
+_boxed_update (PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    if (!PyArg_ParseTuple (args, ":update"))
+        return NULL;
+
+    return _pygi_struct_update (self, &PyGIBaseInfo_Type, kwargs);
+}
+
+static PyObject *
+_boxed_from_tuple (PyObject *type, PyObject *values)
+{
+    return _pygi_struct_from_tuple ( (PyTypeObject *) type, &PyGIBaseInfo_Type, values);
+}
+
+static PyObject *
+_boxed_as_tuples (PyObject *type, PyObject *structs)
+{
+    return _pygi_struct_as_tuples ( (PyTypeObject *) type, &PyGIBaseInfo_Type, structs);
+}
+
+static PyObject *
+_boxed_get_pack_format (PyObject *type)
+{
+    return _pygi_struct_get_pack_format ( (PyTypeObject *) type, &PyGIBaseInfo_Type);
+}
+
+static PyObject *
+_boxed_pack (PyObject *type, PyObject *structs)
+{
+    return _pygi_struct_pack ( (PyTypeObject *) type, &PyGIBaseInfo_Type, structs);
+}
+
+static PyMethodDef _boxed_methods[] = {
+    { "as_tuple", (PyCFunction) _boxed_as_tuple, METH_NOARGS },
+    { "as_dict", (PyCFunction) _boxed_as_dict, METH_NOARGS },
+    { "update", (PyCFunction) _boxed_update, METH_VARARGS | METH_KEYWORDS },
+    { "from_tuple", (PyCFunction) _boxed_from_tuple, METH_O | METH_CLASS },
+    { "as_tuples", (PyCFunction) _boxed_as_tuples, METH_O | METH_CLASS },
+    { "get_pack_format", (PyCFunction) _boxed_get_pack_format, METH_NOARGS | METH_CLASS },
+    { "pack", (PyCFunction) _boxed_pack, METH_O | METH_CLASS },
+    { NULL, NULL, 0 }
+};
+
 PYGLIB_DEFINE_TYPE("gi.Boxed", PyGIBoxed_Type, PyGIBoxed);
 
 PyObject *
@@ -140,7 +214,9 @@ _pygi_boxed_new (PyTypeObject *type,
                  gpointer      boxed,
                  gboolean      free_on_dealloc)
 {
+    PyGIStructTypeCache *cache;
     PyGIBoxed *self;
+    GType g_type;
 
     if (!boxed) {
         Py_RETURN_NONE;
@@ -151,12 +227,20 @@ _pygi_boxed_new (PyTypeObject *type,
         return NULL;
     }
 
-    self = (PyGIBoxed *) type->tp_alloc (type, 0);
+    cache = _pygi_struct_type_cache (type, &PyGIBaseInfo_Type);
+    if (cache != NULL) {
+        g_type = cache->g_type;
+    } else {
+        PyErr_Clear();
+        g_type = pyg_type_from_object ( (PyObject *) type);
+    }
+
+    self = (PyGIBoxed *) _pygi_struct_alloc (type, cache);
     if (self == NULL) {
         return NULL;
     }
 
-    ( (PyGBoxed *) self)->gtype = pyg_type_from_object ( (PyObject *) type);
+    ( (PyGBoxed *) self)->gtype = g_type;
     ( (PyGBoxed *) self)->boxed = boxed;
     ( (PyGBoxed *) self)->free_on_dealloc = free_on_dealloc;
     self->size = 0;
@@ -173,6 +257,7 @@ _pygi_boxed_register_types (PyObject *m)
     PyGIBoxed_Type.tp_new = (newfunc) _boxed_new;
     PyGIBoxed_Type.tp_init = (initproc) _boxed_init;
     PyGIBoxed_Type.tp_dealloc = (destructor) _boxed_dealloc;
+    PyGIBoxed_Type.tp_methods = _boxed_methods;
     PyGIBoxed_Type.tp_flags = (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE);
 
     if (PyType_Ready (&PyGIBoxed_Type))
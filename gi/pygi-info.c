@@ -1148,10 +1148,9 @@ static PyMethodDef _PyGIValueInfo_methods[] = {
 PYGLIB_DEFINE_TYPE ("gi.FieldInfo", PyGIFieldInfo_Type, PyGIBaseInfo);
 
 static PyObject *
-_wrap_g_field_info_get_value (PyGIBaseInfo *self,
-                              PyObject     *args)
+_field_info_get_value (GIBaseInfo *field_info,
+                       PyObject   *instance)
 {
-    PyObject *instance;
     GIBaseInfo *container_info;
     GIInfoType container_info_type;
     gpointer pointer;
@@ -1161,11 +1160,7 @@ _wrap_g_field_info_get_value (PyGIBaseInfo *self,
 
     memset(&value, 0, sizeof(GIArgument));
 
-    if (!PyArg_ParseTuple (args, "O:FieldInfo.get_value", &instance)) {
-        return NULL;
-    }
-
-    container_info = g_base_info_get_container (self->info);
+    container_info = g_base_info_get_container (field_info);
     g_assert (container_info != NULL);
 
     /* Check the instance. */
@@ -1190,7 +1185,7 @@ _wrap_g_field_info_get_value (PyGIBaseInfo *self,
     }
 
     /* Get the field's value. */
-    field_type_info = g_field_info_get_type ( (GIFieldInfo *) self->info);
+    field_type_info = g_field_info_get_type ( (GIFieldInfo *) field_info);
 
     /* A few types are not handled by g_field_info_get_field, so do it here. */
     if (!g_type_info_is_pointer (field_type_info)
@@ -1198,7 +1193,7 @@ _wrap_g_field_info_get_value (PyGIBaseInfo *self,
         GIBaseInfo *info;
         GIInfoType info_type;
 
-        if (! (g_field_info_get_flags ( (GIFieldInfo *) self->info) & GI_FIELD_IS_READABLE)) {
+        if (! (g_field_info_get_flags ( (GIFieldInfo *) field_info) & GI_FIELD_IS_READABLE)) {
             PyErr_SetString (PyExc_RuntimeError, "field is not readable");
             goto out;
         }
@@ -1217,7 +1212,7 @@ _wrap_g_field_info_get_value (PyGIBaseInfo *self,
             {
                 gsize offset;
 
-                offset = g_field_info_get_offset ( (GIFieldInfo *) self->info);
+                offset = g_field_info_get_offset ( (GIFieldInfo *) field_info);
 
                 value.v_pointer = pointer + offset;
 
@@ -1229,7 +1224,7 @@ _wrap_g_field_info_get_value (PyGIBaseInfo *self,
         }
     }
 
-    if (!g_field_info_get_field ( (GIFieldInfo *) self->info, pointer, &value)) {
+    if (!g_field_info_get_field ( (GIFieldInfo *) field_info, pointer, &value)) {
         PyErr_SetString (PyExc_RuntimeError, "unable to get the value");
         goto out;
     }
@@ -1256,11 +1251,10 @@ out:
 }
 
 static PyObject *
-_wrap_g_field_info_set_value (PyGIBaseInfo *self,
-                              PyObject     *args)
+_field_info_set_value (GIBaseInfo *field_info,
+                       PyObject   *instance,
+                       PyObject   *py_value)
 {
-    PyObject *instance;
-    PyObject *py_value;
     GIBaseInfo *container_info;
     GIInfoType container_info_type;
     gpointer pointer;
@@ -1268,11 +1262,7 @@ _wrap_g_field_info_set_value (PyGIBaseInfo *self,
     GIArgument value;
     PyObject *retval = NULL;
 
-    if (!PyArg_ParseTuple (args, "OO:FieldInfo.set_value", &instance, &py_value)) {
-        return NULL;
-    }
-
-    container_info = g_base_info_get_container (self->info);
+    container_info = g_base_info_get_container (field_info);
     g_assert (container_info != NULL);
 
     /* Check the instance. */
@@ -1296,7 +1286,7 @@ _wrap_g_field_info_set_value (PyGIBaseInfo *self,
             g_assert_not_reached();
     }
 
-    field_type_info = g_field_info_get_type ( (GIFieldInfo *) self->info);
+    field_type_info = g_field_info_get_type ( (GIFieldInfo *) field_info);
 
     /* Check the value. */
     {
@@ -1320,7 +1310,7 @@ _wrap_g_field_info_set_value (PyGIBaseInfo *self,
         GIBaseInfo *info;
         GIInfoType info_type;
 
-        if (! (g_field_info_get_flags ( (GIFieldInfo *) self->info) & GI_FIELD_IS_WRITABLE)) {
+        if (! (g_field_info_get_flags ( (GIFieldInfo *) field_info) & GI_FIELD_IS_WRITABLE)) {
             PyErr_SetString (PyExc_RuntimeError, "field is not writable");
             goto out;
         }
@@ -1354,7 +1344,7 @@ _wrap_g_field_info_set_value (PyGIBaseInfo *self,
                     goto out;
                 }
 
-                offset = g_field_info_get_offset ( (GIFieldInfo *) self->info);
+                offset = g_field_info_get_offset ( (GIFieldInfo *) field_info);
                 size = g_struct_info_get_size ( (GIStructInfo *) info);
                 g_assert (size > 0);
 
@@ -1378,7 +1368,7 @@ _wrap_g_field_info_set_value (PyGIBaseInfo *self,
         goto out;
     }
 
-    if (!g_field_info_set_field ( (GIFieldInfo *) self->info, pointer, &value)) {
+    if (!g_field_info_set_field ( (GIFieldInfo *) field_info, pointer, &value)) {
         _pygi_argument_release (&value, field_type_info, GI_TRANSFER_NOTHING, GI_DIRECTION_IN);
         PyErr_SetString (PyExc_RuntimeError, "unable to set value for field");
         goto out;
@@ -1393,12 +1383,452 @@ out:
     return retval;
 }
 
+static PyObject *
+_wrap_g_field_info_get_value (PyGIBaseInfo *self,
+                              PyObject     *args)
+{
+    PyObject *instance;
+
+    if (!PyArg_ParseTuple (args, "O:FieldInfo.get_value", &instance)) {
+        return NULL;
+    }
+
+    return _field_info_get_value (self->info, instance);
+}
+
+static PyObject *
+_wrap_g_field_info_set_value (PyGIBaseInfo *self,
+                              PyObject     *args)
+{
+    PyObject *instance;
+    PyObject *py_value;
+
+    if (!PyArg_ParseTuple (args, "OO:FieldInfo.set_value", &instance, &py_value)) {
+        return NULL;
+    }
+
+    return _field_info_set_value (self->info, instance, py_value);
+}
+
 static PyMethodDef _PyGIFieldInfo_methods[] = {
     { "get_value", (PyCFunction) _wrap_g_field_info_get_value, METH_VARARGS },
     { "set_value", (PyCFunction) _wrap_g_field_info_set_value, METH_VARARGS },
     { NULL, NULL, 0 }
 };
 
+/* Field layouts
+ *
+ * The offset and storage of a field, resolved once, so that plain numeric
+ * fields can be read with a single load and written with a single store.
+ * Other fields and unexpected values go through FieldInfo.
+ */
+gboolean
+_pygi_field_layout_init (PyGIFieldLayout *layout,
+                         GIFieldInfo     *field_info)
+{
+    GIBaseInfo *container_info;
+    GITypeInfo *field_type_info;
+    GIFieldInfoFlags flags;
+    gboolean is_simple;
+
+    container_info = g_base_info_get_container ( (GIBaseInfo *) field_info);
+    if (container_info == NULL) {
+        PyErr_SetString (PyExc_TypeError, "field has no container");
+        return FALSE;
+    }
+
+    switch (g_base_info_get_type (container_info)) {
+        case GI_INFO_TYPE_UNION:
+        case GI_INFO_TYPE_STRUCT:
+            layout->is_object = FALSE;
+            break;
+        case GI_INFO_TYPE_OBJECT:
+            layout->is_object = TRUE;
+            break;
+        default:
+            PyErr_SetString (PyExc_TypeError,
+                             "only struct, union and object fields are supported");
+            return FALSE;
+    }
+
+    layout->info = g_base_info_ref ( (GIBaseInfo *) field_info);
+
+    field_type_info = g_field_info_get_type (field_info);
+    layout->type_tag = g_type_info_get_tag (field_type_info);
+    layout->offset = g_field_info_get_offset (field_info);
+
+    /* Bitfields and everything that needs more than boxing the stored
+     * value are left to FieldInfo. */
+    is_simple = !g_type_info_is_pointer (field_type_info)
+                && g_field_info_get_size (field_info) == 0;
+    switch (layout->type_tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+        case GI_TYPE_TAG_INT8:
+        case GI_TYPE_TAG_UINT8:
+        case GI_TYPE_TAG_INT16:
+        case GI_TYPE_TAG_UINT16:
+        case GI_TYPE_TAG_INT32:
+        case GI_TYPE_TAG_UINT32:
+        case GI_TYPE_TAG_INT64:
+        case GI_TYPE_TAG_UINT64:
+        case GI_TYPE_TAG_FLOAT:
+        case GI_TYPE_TAG_DOUBLE:
+            break;
+        default:
+            is_simple = FALSE;
+            break;
+    }
+
+    flags = g_field_info_get_flags (field_info);
+    layout->fast_get = is_simple && (flags & GI_FIELD_IS_READABLE);
+    layout->fast_set = is_simple && (flags & GI_FIELD_IS_WRITABLE);
+
+    g_base_info_unref ( (GIBaseInfo *) field_type_info);
+
+    return TRUE;
+}
+
+void
+_pygi_field_layout_clear (PyGIFieldLayout *layout)
+{
+    if (layout->info != NULL) {
+        g_base_info_unref (layout->info);
+        layout->info = NULL;
+    }
+}
+
+/**
+ * _pygi_field_layout_get:
+ * @layout: the layout of the field
+ * @instance: the struct, union or object
+ * @pointer: the C instance wrapped by @instance, or %NULL if @instance
+ *           still has to be checked
+ *
+ * Returns: a new reference to the value of the field, or %NULL with an
+ * exception set
+ */
+PyObject *
+_pygi_field_layout_get (PyGIFieldLayout *layout,
+                        PyObject        *instance,
+                        gpointer         pointer)
+{
+    gpointer field;
+
+    if (!layout->fast_get || pointer == NULL) {
+        return _field_info_get_value (layout->info, instance);
+    }
+
+    field = (guint8 *) pointer + layout->offset;
+
+    switch (layout->type_tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+            return PyBool_FromLong (* (gboolean *) field);
+        case GI_TYPE_TAG_INT8:
+            return PYGLIB_PyLong_FromLong (* (gint8 *) field);
+        case GI_TYPE_TAG_UINT8:
+            return PYGLIB_PyLong_FromLong (* (guint8 *) field);
+        case GI_TYPE_TAG_INT16:
+            return PYGLIB_PyLong_FromLong (* (gint16 *) field);
+        case GI_TYPE_TAG_UINT16:
+            return PYGLIB_PyLong_FromLong (* (guint16 *) field);
+        case GI_TYPE_TAG_INT32:
+            return PYGLIB_PyLong_FromLong (* (gint32 *) field);
+        case GI_TYPE_TAG_UINT32:
+            return PyLong_FromLongLong (* (guint32 *) field);
+        case GI_TYPE_TAG_INT64:
+            return PyLong_FromLongLong (* (gint64 *) field);
+        case GI_TYPE_TAG_UINT64:
+            return PyLong_FromUnsignedLongLong (* (guint64 *) field);
+        case GI_TYPE_TAG_FLOAT:
+            return PyFloat_FromDouble (* (gfloat *) field);
+        case GI_TYPE_TAG_DOUBLE:
+            return PyFloat_FromDouble (* (gdouble *) field);
+        default:
+            g_assert_not_reached();
+            return NULL;
+    }
+}
+
+/* Returns 1 when the value was stored, 0 when it has to go through
+ * FieldInfo, which reports the conversion errors, and -1 on error. */
+static int
+_field_layout_set_simple (PyGIFieldLayout *layout,
+                          gpointer         field,
+                          PyObject        *value)
+{
+    PY_LONG_LONG v;
+
+    switch (layout->type_tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+        {
+            int is_true = PyObject_IsTrue (value);
+            if (is_true < 0) {
+                return -1;
+            }
+            * (gboolean *) field = is_true;
+            return 1;
+        }
+        case GI_TYPE_TAG_FLOAT:
+        case GI_TYPE_TAG_DOUBLE:
+        {
+            gdouble d;
+
+            if (PyFloat_CheckExact (value)) {
+                d = PyFloat_AS_DOUBLE (value);
+            } else if (PYGLIB_PyLong_Check (value)) {
+#if PY_VERSION_HEX < 0x03000000
+                d = PyInt_AS_LONG (value);
+#else
+                d = PyLong_AsDouble (value);
+                if (d == -1.0 && PyErr_Occurred()) {
+                    PyErr_Clear();
+                    return 0;
+                }
+#endif
+            } else {
+                return 0;
+            }
+            if (layout->type_tag == GI_TYPE_TAG_FLOAT) {
+                if (d < -G_MAXFLOAT || d > G_MAXFLOAT) {
+                    return 0;
+                }
+                * (gfloat *) field = (gfloat) d;
+            } else {
+                if (d < -G_MAXDOUBLE || d > G_MAXDOUBLE) {
+                    return 0;
+                }
+                * (gdouble *) field = d;
+            }
+            return 1;
+        }
+        default:
+            break;
+    }
+
+#if PY_VERSION_HEX < 0x03000000
+    if (!PyInt_Check (value)) {
+        return 0;
+    }
+    v = PyInt_AS_LONG (value);
+#else
+    {
+        int overflow;
+
+        if (!PyLong_Check (value)) {
+            return 0;
+        }
+        v = PyLong_AsLongLongAndOverflow (value, &overflow);
+        if (overflow) {
+            return 0;
+        }
+        if (v == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+    }
+#endif
+
+    switch (layout->type_tag) {
+        case GI_TYPE_TAG_INT8:
+            if (v < G_MININT8 || v > G_MAXINT8)
+                return 0;
+            * (gint8 *) field = (gint8) v;
+            break;
+        case GI_TYPE_TAG_UINT8:
+            if (v < 0 || v > G_MAXUINT8)
+                return 0;
+            * (guint8 *) field = (guint8) v;
+            break;
+        case GI_TYPE_TAG_INT16:
+            if (v < G_MININT16 || v > G_MAXINT16)
+                return 0;
+            * (gint16 *) field = (gint16) v;
+            break;
+        case GI_TYPE_TAG_UINT16:
+            if (v < 0 || v > G_MAXUINT16)
+                return 0;
+            * (guint16 *) field = (guint16) v;
+            break;
+        case GI_TYPE_TAG_INT32:
+            if (v < G_MININT32 || v > G_MAXINT32)
+                return 0;
+            * (gint32 *) field = (gint32) v;
+            break;
+        case GI_TYPE_TAG_UINT32:
+            if (v < 0 || v > G_MAXUINT32)
+                return 0;
+            * (guint32 *) field = (guint32) v;
+            break;
+        case GI_TYPE_TAG_INT64:
+            * (gint64 *) field = (gint64) v;
+            break;
+        case GI_TYPE_TAG_UINT64:
+            if (v < 0)
+                return 0;
+            * (guint64 *) field = (guint64) v;
+            break;
+        default:
+            g_assert_not_reached();
+    }
+
+    return 1;
+}
+
+/**
+ * _pygi_field_layout_set:
+ * @layout: the layout of the field
+ * @instance: the struct, union or object
+ * @pointer: the C instance wrapped by @instance, or %NULL if @instance
+ *           still has to be checked
+ * @value: the new value
+ *
+ * Returns: 0 on success, -1 with an exception set
+ */
+int
+_pygi_field_layout_set (PyGIFieldLayout *layout,
+                        PyObject        *instance,
+                        gpointer         pointer,
+                        PyObject        *value)
+{
+    PyObject *retval;
+
+    if (layout->fast_set && pointer != NULL) {
+        int stored;
+
+        stored = _field_layout_set_simple (layout,
+                                           (guint8 *) pointer + layout->offset,
+                                           value);
+        if (stored != 0) {
+            return stored > 0 ? 0 : -1;
+        }
+    }
+
+    retval = _field_info_set_value (layout->info, instance, value);
+    if (retval == NULL) {
+        return -1;
+    }
+    Py_DECREF (retval);
+
+    return 0;
+}
+
+
+/* FieldDescriptor
+ *
+ * Data descriptor installed on GI classes for each of their fields.
+ */
+typedef struct {
+    PyObject_HEAD
+    PyTypeObject *owner;
+    PyGIFieldLayout layout;
+} PyGIFieldDescriptor;
+
+PYGLIB_DEFINE_TYPE ("gi.FieldDescriptor", PyGIFieldDescriptor_Type, PyGIFieldDescriptor);
+
+static PyObject *
+_field_descriptor_new (PyTypeObject *type,
+                       PyObject     *args,
+                       PyObject     *kwargs)
+{
+    static char *kwlist[] = { "owner", "field_info", NULL };
+    PyTypeObject *owner;
+    PyGIBaseInfo *field_info;
+    PyGIFieldDescriptor *self;
+
+    if (!PyArg_ParseTupleAndKeywords (args, kwargs, "O!O!:FieldDescriptor.__new__",
+                                      kwlist, &PyType_Type, &owner,
+                                      &PyGIFieldInfo_Type, &field_info)) {
+        return NULL;
+    }
+
+    self = (PyGIFieldDescriptor *) type->tp_alloc (type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    if (!_pygi_field_layout_init (&self->layout, (GIFieldInfo *) field_info->info)) {
+        Py_DECREF (self);
+        return NULL;
+    }
+
+    Py_INCREF (owner);
+    self->owner = owner;
+
+    return (PyObject *) self;
+}
+
+static void
+_field_descriptor_dealloc (PyGIFieldDescriptor *self)
+{
+    PyObject_GC_UnTrack ( (PyObject *) self);
+
+    Py_XDECREF (self->owner);
+    _pygi_field_layout_clear (&self->layout);
+
+    Py_TYPE( (PyObject *) self)->tp_free ( (PyObject *) self);
+}
+
+static int
+_field_descriptor_traverse (PyGIFieldDescriptor *self,
+                            visitproc            visit,
+                            void                *arg)
+{
+    Py_VISIT (self->owner);
+    return 0;
+}
+
+static PyObject *
+_field_descriptor_repr (PyGIFieldDescriptor *self)
+{
+    return PYGLIB_PyUnicode_FromFormat ("<field %s of %s>",
+                                        g_base_info_get_name (self->layout.info),
+                                        self->owner->tp_name);
+}
+
+static gpointer
+_field_descriptor_get_pointer (PyGIFieldDescriptor *self,
+                               PyObject            *instance)
+{
+    if (!PyObject_TypeCheck (instance, self->owner)) {
+        return NULL;
+    }
+
+    if (self->layout.is_object) {
+        return pygobject_get (instance);
+    }
+
+    return pyg_boxed_get (instance, void);
+}
+
+static PyObject *
+_field_descriptor_get (PyGIFieldDescriptor *self,
+                       PyObject            *instance,
+                       PyObject            *type)
+{
+    if (instance == NULL || instance == Py_None) {
+        Py_INCREF (self);
+        return (PyObject *) self;
+    }
+
+    return _pygi_field_layout_get (&self->layout, instance,
+                                   _field_descriptor_get_pointer (self, instance));
+}
+
+static int
+_field_descriptor_set (PyGIFieldDescriptor *self,
+                       PyObject            *instance,
+                       PyObject            *value)
+{
+    if (value == NULL) {
+        PyErr_Format (PyExc_AttributeError, "cannot delete field '%s'",
+                      g_base_info_get_name (self->layout.info));
+        return -1;
+    }
+
+    return _pygi_field_layout_set (&self->layout, instance,
+                                   _field_descriptor_get_pointer (self, instance),
+                                   value);
+}
+
 
 /* GIUnresolvedInfo */
 PYGLIB_DEFINE_TYPE ("gi.UnresolvedInfo", PyGIUnresolvedInfo_Type, PyGIBaseInfo);
@@ -1612,6 +2042,21 @@ _pygi_info_register_types (PyObject *m)
     _PyGI_REGISTER_TYPE (m, PyGITypeInfo_Type, TypeInfo,
                          PyGIBaseInfo_Type);
 
+    Py_TYPE(&PyGIFieldDescriptor_Type) = &PyType_Type;
+
+    PyGIFieldDescriptor_Type.tp_new = (newfunc) _field_descriptor_new;
+    PyGIFieldDescriptor_Type.tp_dealloc = (destructor) _field_descriptor_dealloc;
+    PyGIFieldDescriptor_Type.tp_repr = (reprfunc) _field_descriptor_repr;
+    PyGIFieldDescriptor_Type.tp_flags = (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC);
+    PyGIFieldDescriptor_Type.tp_traverse = (traverseproc) _field_descriptor_traverse;
+    PyGIFieldDescriptor_Type.tp_descr_get = (descrgetfunc) _field_descriptor_get;
+    PyGIFieldDescriptor_Type.tp_descr_set = (descrsetfunc) _field_descriptor_set;
+
+    if (PyType_Ready(&PyGIFieldDescriptor_Type))
+        return;
+
+    if (PyModule_AddObject(m, "FieldDescriptor", (PyObject *)&PyGIFieldDescriptor_Type))
+        return;
 
 #undef _PyGI_REGISTER_TYPE
 }
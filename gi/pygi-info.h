@@ -54,6 +54,7 @@ extern PyTypeObject PyGISignalInfo_Type;
 extern PyTypeObject PyGIPropertyInfo_Type;
 extern PyTypeObject PyGIArgInfo_Type;
 extern PyTypeObject PyGITypeInfo_Type;
+extern PyTypeObject PyGIFieldDescriptor_Type;
 
 #define PyGIBaseInfo_GET_GI_INFO(object) g_base_info_ref(((PyGIBaseInfo *)object)->info)
 
@@ -63,6 +64,27 @@ GIBaseInfo* _pygi_object_get_gi_info (PyObject     *object,
 
 gchar* _pygi_g_base_info_get_fullname (GIBaseInfo *info);
 
+/* Where and how a field is stored in its struct, union or object. */
+typedef struct {
+    GIBaseInfo *info;
+    gboolean is_object;
+    gsize offset;
+    GITypeTag type_tag;
+    gboolean fast_get;
+    gboolean fast_set;
+} PyGIFieldLayout;
+
+gboolean _pygi_field_layout_init (PyGIFieldLayout *layout,
+                                  GIFieldInfo     *field_info);
+void _pygi_field_layout_clear (PyGIFieldLayout *layout);
+PyObject *_pygi_field_layout_get (PyGIFieldLayout *layout,
+                                  PyObject        *instance,
+                                  gpointer         pointer);
+int _pygi_field_layout_set (PyGIFieldLayout *layout,
+                            PyObject        *instance,
+                            gpointer         pointer,
+                            PyObject        *value);
+
 gsize _pygi_g_type_tag_size (GITypeTag type_tag);
 gsize _pygi_g_type_info_size (GITypeInfo *type_info);
 
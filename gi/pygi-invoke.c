@@ -22,6 +22,7 @@
  */
 
 #include <pyglib.h>
+#include <time.h>
 #include "pygi-invoke.h"
 
 struct invocation_state
@@ -61,6 +62,11 @@ struct invocation_state
 
     PyObject  *return_value;
 
+    /* the out= keyword argument, and for each caller-allocates argument
+     * the instance it fills in place instead of allocating a new one */
+    PyObject  *py_out;
+    PyObject **out_objects;
+
     GType      implementor_gtype;
 
     /* hack to avoid treating C arrays as GArrays during free
@@ -76,6 +82,33 @@ _initialize_invocation_state (struct invocation_state *state,
                               PyObject *py_args,
                               PyObject *kwargs)
 {
+    state->py_out = NULL;
+    state->out_objects = NULL;
+
+    if (kwargs != NULL) {
+        PyObject *key;
+        PyObject *value;
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next (kwargs, &pos, &key, &value)) {
+            const char *name = PYGLIB_PyUnicode_AsString (key);
+
+            if (name == NULL)
+                return FALSE;
+
+            if (strcmp (name, "out") == 0) {
+                if (value != Py_None)
+                    state->py_out = value;
+            } else if (strcmp (name, "gtype") != 0
+                       || g_base_info_get_type (info) == GI_INFO_TYPE_FUNCTION) {
+                PyErr_Format (PyExc_TypeError,
+                              "%s() got an unexpected keyword argument '%s'",
+                              g_base_info_get_name (info), name);
+                return FALSE;
+            }
+        }
+    }
+
     if (g_base_info_get_type (info) == GI_INFO_TYPE_FUNCTION) {
         GIFunctionInfoFlags flags = g_function_info_get_flags (info);
 
@@ -135,6 +168,83 @@ _initialize_invocation_state (struct invocation_state *state,
     return TRUE;
 }
 
+/* The instance out= gives for the next caller-allocates argument: out=
+ * is either the instance for the first one or a tuple with an instance
+ * or None for each of them. */
+static PyObject *
+_next_out_object (struct invocation_state *state, gsize *out_objects_pos)
+{
+    PyObject *object = NULL;
+
+    if (state->py_out == NULL)
+        return NULL;
+
+    if (PyTuple_Check (state->py_out)) {
+        if (*out_objects_pos < (gsize) PyTuple_GET_SIZE (state->py_out))
+            object = PyTuple_GET_ITEM (state->py_out, *out_objects_pos);
+    } else if (*out_objects_pos == 0) {
+        object = state->py_out;
+    }
+    *out_objects_pos += 1;
+
+    return object != Py_None ? object : NULL;
+}
+
+static gboolean
+_check_out_object (struct invocation_state *state,
+                   GIBaseInfo *function_info,
+                   gsize i,
+                   GIBaseInfo *info,
+                   PyObject *object)
+{
+    gint retval;
+
+    if (g_struct_info_is_foreign ( (GIStructInfo *) info)) {
+        PyErr_Format (PyExc_TypeError,
+                      "%s() cannot fill foreign structures in place",
+                      g_base_info_get_name (function_info));
+        return FALSE;
+    }
+
+    /* the callee initialises the GValue itself, and the normal path
+     * returns the converted value rather than the GValue */
+    if (g_registered_type_info_get_g_type ( (GIRegisteredTypeInfo *) info)
+            == G_TYPE_VALUE) {
+        PyErr_Format (PyExc_TypeError,
+                      "%s() cannot fill GValues in place",
+                      g_base_info_get_name (function_info));
+        return FALSE;
+    }
+
+    retval = _pygi_g_type_info_check_object (state->arg_type_infos[i], object,
+                                             FALSE);
+    if (retval < 0) {
+        return FALSE;
+    } else if (!retval) {
+        _PyGI_ERROR_PREFIX ("out argument %s: ",
+                            g_base_info_get_name ( (GIBaseInfo *) state->arg_infos[i]));
+        return FALSE;
+    }
+
+    /* the type check above lets some non-structures through */
+    if (!PyObject_TypeCheck (object, &PyGIStruct_Type)
+            && !PyObject_TypeCheck (object, &PyGIBoxed_Type)) {
+        PyErr_Format (PyExc_TypeError,
+                      "out argument %s must be a structure, not %s",
+                      g_base_info_get_name ( (GIBaseInfo *) state->arg_infos[i]),
+                      Py_TYPE (object)->tp_name);
+        return FALSE;
+    }
+
+    if (pyg_boxed_get (object, void) == NULL) {
+        PyErr_Format (PyExc_ValueError, "out argument %s has no memory",
+                      g_base_info_get_name ( (GIBaseInfo *) state->arg_infos[i]));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 static gboolean
 _prepare_invocation_state (struct invocation_state *state,
                            GIFunctionInfo *function_info, PyObject *py_args)
@@ -320,14 +430,18 @@ _prepare_invocation_state (struct invocation_state *state,
     state->out_args = g_slice_alloc0 (sizeof (GIArgument) * state->n_out_args);
     state->out_values = g_slice_alloc0 (sizeof (GIArgument) * state->n_out_args);
     state->backup_args = g_slice_alloc0 (sizeof (GIArgument) * state->n_backup_args);
+    if (state->py_out != NULL)
+        state->out_objects = g_slice_alloc0 (sizeof (gpointer) * state->n_args);
 
     /* Bind args so we can use an unique index. */
     {
         gsize in_args_pos;
         gsize out_args_pos;
+        gsize out_objects_pos;
 
         in_args_pos = state->is_method ? 1 : 0;
         out_args_pos = 0;
+        out_objects_pos = 0;
 
         for (i = 0; i < state->n_args; i++) {
             GIDirection direction;
@@ -375,10 +489,19 @@ _prepare_invocation_state (struct invocation_state *state,
                     }
 
                     if (is_caller_allocates) {
+                        PyObject *out_object;
+
                         /* if caller allocates only use one level of indirection */
                         state->out_args[out_args_pos].v_pointer = NULL;
                         state->args[i] = &state->out_args[out_args_pos];
-                        if (g_struct_info_is_foreign((GIStructInfo *) info) ) {
+
+                        out_object = _next_out_object (state, &out_objects_pos);
+                        if (out_object != NULL) {
+                            if (!_check_out_object (state, function_info, i, info, out_object))
+                                return FALSE;
+                            state->args[i]->v_pointer = pyg_boxed_get (out_object, void);
+                            state->out_objects[i] = out_object;
+                        } else if (g_struct_info_is_foreign((GIStructInfo *) info) ) {
                             PyObject *foreign_struct =
                                 pygi_struct_foreign_convert_from_g_argument(info, NULL);
 
@@ -407,6 +530,17 @@ _prepare_invocation_state (struct invocation_state *state,
 
         g_assert (in_args_pos == state->n_in_args);
         g_assert (out_args_pos == state->n_out_args);
+
+        if (state->py_out != NULL
+                && (PyTuple_Check (state->py_out)
+                    ? out_objects_pos < (gsize) PyTuple_GET_SIZE (state->py_out)
+                    : out_objects_pos == 0)) {
+            PyErr_Format (PyExc_TypeError,
+                          "%s() has only %zd caller-allocated out argument(s) to fill",
+                          g_base_info_get_name ( (GIBaseInfo *) function_info),
+                          out_objects_pos);
+            return FALSE;
+        }
     }
 
     /* Convert the input arguments. */
@@ -826,13 +960,17 @@ _process_invocation_state (struct invocation_state *state,
 
             if (direction == GI_DIRECTION_INOUT || direction == GI_DIRECTION_OUT) {
                 /* Convert the argument. */
-                PyObject *obj;
+                PyObject *obj = NULL;
 
                 /* If we created it, deallocate when it goes out of scope
                  * otherwise it is unsafe to deallocate random structures
                  * we are given
                  */
-                if (type_tag == GI_TYPE_TAG_INTERFACE) {
+                if (state->out_objects != NULL && state->out_objects[i] != NULL) {
+                    /* filled in place, hand the same instance back */
+                    obj = state->out_objects[i];
+                    Py_INCREF (obj);
+                } else if (type_tag == GI_TYPE_TAG_INTERFACE) {
                     GIBaseInfo *info;
                     GIInfoType info_type;
                     GType type;
@@ -861,10 +999,12 @@ _process_invocation_state (struct invocation_state *state,
                     }
                 }
 
-                obj = _pygi_argument_to_object (state->args[i], state->arg_type_infos[i], transfer);
                 if (obj == NULL) {
-                    /* TODO: release arguments. */
-                    return FALSE;
+                    obj = _pygi_argument_to_object (state->args[i], state->arg_type_infos[i], transfer);
+                    if (obj == NULL) {
+                        /* TODO: release arguments. */
+                        return FALSE;
+                    }
                 }
 
                 g_assert (return_values_pos < state->n_return_values);
@@ -938,7 +1078,9 @@ _free_invocation_state (struct invocation_state *state)
                 }
                 backup_args_pos += 1;
             }
-            if (state->args != NULL && state->args[i] != NULL) {
+            if (state->out_objects != NULL && state->out_objects[i] != NULL) {
+                /* the memory belongs to the instance given with out= */
+            } else if (state->args != NULL && state->args[i] != NULL) {
                 type_tag = g_type_info_get_tag (state->arg_type_infos[i]);
 
                 if (type_tag == GI_TYPE_TAG_ARRAY &&
@@ -996,18 +1138,201 @@ _free_invocation_state (struct invocation_state *state)
         g_slice_free1 (sizeof (GIArgument) * state->n_backup_args, state->backup_args);
     }
 
+    if (state->out_objects != NULL) {
+        g_slice_free1 (sizeof (gpointer) * state->n_args, state->out_objects);
+    }
+
     if (PyErr_Occurred()) {
         Py_CLEAR (state->return_value);
     }
 }
 
 
+
+/* Invocation statistics.  Every phase of the invocation runs with the GIL
+ * held, except the C call which takes it back before returning, so the
+ * GIL is what protects the table. */
+
+typedef struct
+{
+    GIBaseInfo *info;
+    guint64 calls;
+    guint64 errors;
+    guint64 prepare_time;	/* in nanoseconds */
+    guint64 invoke_time;
+    guint64 process_time;
+    guint64 release_time;
+} PyGIInvokeRecord;
+
+static GHashTable *_invoke_stats = NULL;
+
+/* a single phase of a call often takes less than a microsecond */
+static gint64
+_invoke_stats_now (void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+        return (gint64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+    return _pyglib_get_monotonic_time () * 1000;
+}
+
+static guint
+_invoke_stats_hash (gconstpointer info)
+{
+    /* the name lives in the typelib, distinct GIBaseInfo of one
+     * function share it */
+    return g_direct_hash (g_base_info_get_name ( (GIBaseInfo *) info));
+}
+
+static gboolean
+_invoke_stats_equal (gconstpointer a, gconstpointer b)
+{
+    return g_base_info_equal ( (GIBaseInfo *) a, (GIBaseInfo *) b);
+}
+
+static void
+_invoke_record_free (gpointer data)
+{
+    PyGIInvokeRecord *record = data;
+
+    g_base_info_unref (record->info);
+    g_slice_free (PyGIInvokeRecord, record);
+}
+
+static GHashTable *
+_invoke_stats_new (void)
+{
+    return g_hash_table_new_full (_invoke_stats_hash, _invoke_stats_equal,
+                                  NULL, _invoke_record_free);
+}
+
+static PyObject *
+_invoke_with_stats (PyGIBaseInfo *self, PyObject *py_args, PyObject *kwargs)
+{
+    struct invocation_state state = { 0, };
+    PyGIInvokeRecord *record;
+    gint64 t0, t1, t2, t3, t4;
+    gboolean ok;
+
+    t0 = _invoke_stats_now();
+    ok = _initialize_invocation_state (&state, self->info, py_args, kwargs)
+         && _prepare_invocation_state (&state, self->info, py_args);
+    t1 = _invoke_stats_now();
+    ok = ok && _invoke_function (&state, self->info, py_args);
+    t2 = _invoke_stats_now();
+    ok = ok && _process_invocation_state (&state, self->info, py_args);
+    t3 = _invoke_stats_now();
+    _free_invocation_state (&state);
+    t4 = _invoke_stats_now();
+
+    /* looked up last, the call may have reset or disabled the statistics */
+    if (_invoke_stats != NULL) {
+        record = g_hash_table_lookup (_invoke_stats, self->info);
+        if (record == NULL) {
+            record = g_slice_new0 (PyGIInvokeRecord);
+            record->info = g_base_info_ref (self->info);
+            g_hash_table_insert (_invoke_stats, record->info, record);
+        }
+        record->calls++;
+        if (!ok)
+            record->errors++;
+        record->prepare_time += t1 - t0;
+        record->invoke_time += t2 - t1;
+        record->process_time += t3 - t2;
+        record->release_time += t4 - t3;
+    }
+
+    return ok ? state.return_value : NULL;
+}
+
+void
+_pygi_invoke_stats_enable (gboolean enable)
+{
+    if (enable && _invoke_stats == NULL) {
+        _invoke_stats = _invoke_stats_new();
+    } else if (!enable && _invoke_stats != NULL) {
+        GHashTable *stats = _invoke_stats;
+
+        _invoke_stats = NULL;
+        g_hash_table_destroy (stats);
+    }
+}
+
+PyObject *
+_pygi_invoke_stats_get (gboolean reset)
+{
+    GHashTableIter iter;
+    PyGIInvokeRecord *record;
+    GArray *records;
+    PyObject *py_list;
+    guint i;
+
+    if (_invoke_stats == NULL)
+        return PyList_New (0);
+
+    /* copy first: building the list may run Python code, and with it GI
+     * calls updating the table */
+    records = g_array_sized_new (FALSE, FALSE, sizeof (PyGIInvokeRecord),
+                                 g_hash_table_size (_invoke_stats));
+    g_hash_table_iter_init (&iter, _invoke_stats);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &record)) {
+        g_base_info_ref (record->info);
+        g_array_append_val (records, *record);
+    }
+    if (reset)
+        g_hash_table_remove_all (_invoke_stats);
+
+    py_list = PyList_New (0);
+    for (i = 0; i < records->len; i++) {
+        GIBaseInfo *container;
+        PyObject *py_record;
+        gchar *name;
+
+        record = &g_array_index (records, PyGIInvokeRecord, i);
+        if (py_list == NULL)
+            goto next;
+
+        container = g_base_info_get_container (record->info);
+        if (container != NULL)
+            name = g_strjoin (".", g_base_info_get_namespace (record->info),
+                              g_base_info_get_name (container),
+                              g_base_info_get_name (record->info), NULL);
+        else
+            name = g_strjoin (".", g_base_info_get_namespace (record->info),
+                              g_base_info_get_name (record->info), NULL);
+
+        py_record = Py_BuildValue ("{s:s,s:K,s:K,s:d,s:d,s:d,s:d}",
+                                   "name", name,
+                                   "calls", record->calls,
+                                   "errors", record->errors,
+                                   "prepare_time", record->prepare_time / 1e9,
+                                   "invoke_time", record->invoke_time / 1e9,
+                                   "process_time", record->process_time / 1e9,
+                                   "release_time", record->release_time / 1e9);
+        g_free (name);
+        if (py_record == NULL || PyList_Append (py_list, py_record) < 0)
+            Py_CLEAR (py_list);
+        Py_XDECREF (py_record);
+next:
+        g_base_info_unref (record->info);
+    }
+    g_array_free (records, TRUE);
+
+    return py_list;
+}
+
 PyObject *
 _wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
                               PyObject *kwargs)
 {
     struct invocation_state state = { 0, };
 
+    if (G_UNLIKELY (_invoke_stats != NULL))
+        return _invoke_with_stats (self, py_args, kwargs);
+
     if (!_initialize_invocation_state (&state, self->info, py_args, kwargs)) {
         _free_invocation_state (&state);
         return NULL;
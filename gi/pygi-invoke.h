@@ -33,6 +33,9 @@ G_BEGIN_DECLS
 PyObject *_wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
                                         PyObject *kwargs);
 
+void _pygi_invoke_stats_enable (gboolean enable);
+PyObject *_pygi_invoke_stats_get (gboolean reset);
+
 G_END_DECLS
 
 #endif /* __PYGI_INVOKE_H__ */
@@ -27,26 +27,785 @@
 #include <girepository.h>
 #include <pyglib-python-compat.h>
 
+static void
+_struct_type_cache_clear_fields (PyGIStructTypeCache *cache)
+{
+    guint i;
+
+    for (i = 0; i < cache->n_fields; i++)
+        _pygi_field_layout_clear (&cache->fields[i]);
+    g_free (cache->fields);
+    cache->fields = NULL;
+    cache->n_fields = 0;
+    Py_CLEAR (cache->field_names);
+    g_free (cache->pack_format);
+    cache->pack_format = NULL;
+    cache->pack_size = 0;
+}
+
+static void
+_struct_type_cache_free (PyGIStructTypeCache *cache)
+{
+    _struct_type_cache_clear_fields (cache);
+    if (cache->freelist != NULL)
+        _pyglib_freelist_destroy (cache->freelist);
+    if (cache->inline_freelist != NULL)
+        _pyglib_freelist_destroy (cache->inline_freelist);
+    g_base_info_unref (cache->info);
+    g_slice_free (PyGIStructTypeCache, cache);
+}
+
+#if PY_VERSION_HEX >= 0x03000000
+static void
+_struct_type_cache_capsule_free (PyObject *capsule)
+{
+    _struct_type_cache_free (PyCapsule_GetPointer (capsule, NULL));
+}
+#endif
+
+static PyObject *_struct_type_cache_key = NULL;
+
+/**
+ * _pygi_struct_type_cache_peek:
+ * @type: a gi.Struct or gi.Boxed subclass
+ *
+ * Returns: the cache of @type when _pygi_struct_type_cache() already
+ * computed it, %NULL otherwise; never raises, so that tp_dealloc can
+ * use it
+ */
+PyGIStructTypeCache *
+_pygi_struct_type_cache_peek (PyTypeObject *type)
+{
+    PyObject *capsule;
+
+    /* only the dictionary of @type itself: a subclass defined in Python
+     * has its own layout */
+    if (_struct_type_cache_key == NULL || type->tp_dict == NULL)
+        return NULL;
+
+    capsule = PyDict_GetItem (type->tp_dict, _struct_type_cache_key);
+    if (capsule == NULL)
+        return NULL;
+    return PYGLIB_CPointer_GetPointer (capsule, NULL);
+}
+
+/**
+ * _pygi_struct_type_cache:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @info_type: the type its __info__ must have
+ *
+ * Returns the introspection information, GType and size of @type.  They
+ * are looked up the first time and then kept in the dictionary of
+ * @type, so that constructing and destroying instances does not need
+ * the __info__ and __gtype__ attributes anymore.
+ *
+ * Returns: a borrowed cache, or %NULL with an exception set
+ */
+PyGIStructTypeCache *
+_pygi_struct_type_cache (PyTypeObject *type, PyTypeObject *info_type)
+{
+    PyGIStructTypeCache *cache;
+    PyObject *capsule;
+    GIBaseInfo *info;
+
+    if (_struct_type_cache_key == NULL) {
+        _struct_type_cache_key = PYGLIB_PyUnicode_FromString ("__gi_struct_cache__");
+        if (_struct_type_cache_key == NULL)
+            return NULL;
+    }
+
+    cache = _pygi_struct_type_cache_peek (type);
+    if (cache != NULL)
+        return cache;
+
+    info = _pygi_object_get_gi_info ( (PyObject *) type, info_type);
+    if (info == NULL) {
+        if (PyErr_ExceptionMatches (PyExc_AttributeError)) {
+            PyErr_Format (PyExc_TypeError, "missing introspection information");
+        }
+        return NULL;
+    }
+
+    cache = g_slice_new0 (PyGIStructTypeCache);
+    cache->info = info;
+    cache->g_type = pyg_type_from_object ( (PyObject *) type);
+    if (cache->g_type == 0) {
+        _struct_type_cache_free (cache);
+        return NULL;
+    }
+
+    if (cache->g_type == G_TYPE_VALUE) {
+        /* FIXME: Remove when bgo#622711 is fixed */
+        cache->size = sizeof (GValue);
+    } else {
+        switch (g_base_info_get_type (info)) {
+            case GI_INFO_TYPE_UNION:
+                cache->size = g_union_info_get_size ( (GIUnionInfo *) info);
+                break;
+            case GI_INFO_TYPE_BOXED:
+            case GI_INFO_TYPE_STRUCT:
+                cache->size = g_struct_info_get_size ( (GIStructInfo *) info);
+                cache->is_foreign = g_struct_info_is_foreign ( (GIStructInfo *) info);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /* instances of types allocating their own way can have any size */
+    if (type->tp_alloc == PyType_GenericAlloc && type->tp_itemsize == 0) {
+        cache->freelist = _pyglib_freelist_new (type->tp_name,
+                                                type->tp_basicsize,
+                                                PyType_IS_GC (type));
+#if PY_VERSION_HEX < 0x030B0000
+        if (cache->size > 0 && cache->size <= PYGI_INLINE_STRUCT_MAX) {
+            gchar *name;
+
+            name = g_strconcat (type->tp_name, " (inline)", NULL);
+            cache->inline_freelist = _pyglib_freelist_new (name,
+                _PYGI_INLINE_OFFSET (type) + cache->size,
+                PyType_IS_GC (type));
+            g_free (name);
+        }
+#endif
+    }
+
+#if PY_VERSION_HEX >= 0x03000000
+    capsule = PyCapsule_New (cache, NULL, _struct_type_cache_capsule_free);
+#else
+    capsule = PyCObject_FromVoidPtr (cache,
+                                     (void (*)(void *)) _struct_type_cache_free);
+#endif
+    if (capsule == NULL) {
+        _struct_type_cache_free (cache);
+        return NULL;
+    }
+
+    if (PyObject_SetAttr ( (PyObject *) type, _struct_type_cache_key, capsule) < 0)
+        cache = NULL;
+    Py_DECREF (capsule);
+
+    return cache;
+}
+
+/**
+ * _pygi_struct_type_cache_fields:
+ * @cache: a cache returned by _pygi_struct_type_cache()
+ *
+ * Resolves the layout of the fields of the type the first time it is
+ * needed, along with their Python names and, when all of them are plain
+ * numbers, the format of the struct module packing them.
+ *
+ * Returns: %FALSE with an exception set on error
+ */
+gboolean
+_pygi_struct_type_cache_fields (PyGIStructTypeCache *cache)
+{
+    GString *format;
+    gboolean packable = TRUE;
+    gint n_fields;
+    gint i;
+
+    if (cache->fields != NULL)
+        return TRUE;
+
+    switch (g_base_info_get_type (cache->info)) {
+        case GI_INFO_TYPE_UNION:
+            n_fields = g_union_info_get_n_fields ( (GIUnionInfo *) cache->info);
+            break;
+        case GI_INFO_TYPE_BOXED:
+        case GI_INFO_TYPE_STRUCT:
+            n_fields = g_struct_info_get_n_fields ( (GIStructInfo *) cache->info);
+            break;
+        default:
+            n_fields = 0;
+            break;
+    }
+
+    cache->field_names = PyTuple_New (n_fields);
+    if (cache->field_names == NULL)
+        return FALSE;
+
+    cache->fields = g_new0 (PyGIFieldLayout, MAX (n_fields, 1));
+    format = g_string_new ("=");
+
+    for (i = 0; i < n_fields; i++) {
+        GIFieldInfo *field_info;
+        PyGIFieldLayout *layout = &cache->fields[i];
+        gchar *name;
+        PyObject *py_name;
+        gboolean ok;
+
+        if (g_base_info_get_type (cache->info) == GI_INFO_TYPE_UNION)
+            field_info = g_union_info_get_field ( (GIUnionInfo *) cache->info, i);
+        else
+            field_info = g_struct_info_get_field ( (GIStructInfo *) cache->info, i);
+
+        name = g_strdup (g_base_info_get_name ( (GIBaseInfo *) field_info));
+        g_strdelimit (name, "-", '_');
+        py_name = PYGLIB_PyUnicode_FromString (name);
+        g_free (name);
+
+        ok = py_name != NULL && _pygi_field_layout_init (layout, field_info);
+        g_base_info_unref ( (GIBaseInfo *) field_info);
+        if (!ok) {
+            Py_XDECREF (py_name);
+            goto error;
+        }
+        PyTuple_SET_ITEM (cache->field_names, i, py_name);
+        cache->n_fields++;
+
+        if (!layout->fast_get) {
+            packable = FALSE;
+            continue;
+        }
+
+        switch (layout->type_tag) {
+            case GI_TYPE_TAG_BOOLEAN: g_string_append_c (format, 'i'); break;
+            case GI_TYPE_TAG_INT8:    g_string_append_c (format, 'b'); break;
+            case GI_TYPE_TAG_UINT8:   g_string_append_c (format, 'B'); break;
+            case GI_TYPE_TAG_INT16:   g_string_append_c (format, 'h'); break;
+            case GI_TYPE_TAG_UINT16:  g_string_append_c (format, 'H'); break;
+            case GI_TYPE_TAG_INT32:   g_string_append_c (format, 'i'); break;
+            case GI_TYPE_TAG_UINT32:  g_string_append_c (format, 'I'); break;
+            case GI_TYPE_TAG_INT64:   g_string_append_c (format, 'q'); break;
+            case GI_TYPE_TAG_UINT64:  g_string_append_c (format, 'Q'); break;
+            case GI_TYPE_TAG_FLOAT:   g_string_append_c (format, 'f'); break;
+            case GI_TYPE_TAG_DOUBLE:  g_string_append_c (format, 'd'); break;
+            default:
+                g_assert_not_reached();
+        }
+        cache->pack_size += _pygi_g_type_tag_size (layout->type_tag);
+    }
+
+    if (packable && n_fields > 0)
+        cache->pack_format = g_string_free (format, FALSE);
+    else
+        g_string_free (format, TRUE);
+
+    return TRUE;
+
+error:
+    g_string_free (format, TRUE);
+    _struct_type_cache_clear_fields (cache);
+    return FALSE;
+}
+
+static PyGIStructTypeCache *
+_struct_fields_cache (PyTypeObject *type, PyTypeObject *info_type)
+{
+    PyGIStructTypeCache *cache;
+
+    cache = _pygi_struct_type_cache (type, info_type);
+    if (cache == NULL || !_pygi_struct_type_cache_fields (cache))
+        return NULL;
+
+    return cache;
+}
+
+static PyObject *
+_struct_fields_as_tuple (PyGIStructTypeCache *cache, PyObject *self)
+{
+    gpointer pointer = pyg_boxed_get (self, void);
+    PyObject *tuple;
+    guint i;
+
+    tuple = PyTuple_New (cache->n_fields);
+    if (tuple == NULL)
+        return NULL;
+
+    for (i = 0; i < cache->n_fields; i++) {
+        PyObject *value;
+
+        value = _pygi_field_layout_get (&cache->fields[i], self, pointer);
+        if (value == NULL) {
+            Py_DECREF (tuple);
+            return NULL;
+        }
+        PyTuple_SET_ITEM (tuple, i, value);
+    }
+
+    return tuple;
+}
+
+static int
+_struct_check_instance (PyTypeObject *type, PyObject *object)
+{
+    if (!PyObject_TypeCheck (object, type)) {
+        PyErr_Format (PyExc_TypeError, "expected %s, not %s",
+                      type->tp_name, Py_TYPE (object)->tp_name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * _pygi_struct_as_tuple:
+ * @self: a gi.Struct or gi.Boxed instance
+ * @info_type: the type the __info__ of @self has
+ *
+ * Returns: a tuple of the values of the fields of @self, in the order
+ * they are declared
+ */
+PyObject *
+_pygi_struct_as_tuple (PyObject *self, PyTypeObject *info_type)
+{
+    PyGIStructTypeCache *cache;
+
+    cache = _struct_fields_cache (Py_TYPE (self), info_type);
+    if (cache == NULL)
+        return NULL;
+
+    return _struct_fields_as_tuple (cache, self);
+}
+
+PyObject *
+_pygi_struct_as_dict (PyObject *self, PyTypeObject *info_type)
+{
+    PyGIStructTypeCache *cache;
+    gpointer pointer = pyg_boxed_get (self, void);
+    PyObject *dict;
+    guint i;
+
+    cache = _struct_fields_cache (Py_TYPE (self), info_type);
+    if (cache == NULL)
+        return NULL;
+
+    dict = PyDict_New ();
+    if (dict == NULL)
+        return NULL;
+
+    for (i = 0; i < cache->n_fields; i++) {
+        PyObject *value;
+        int retval;
+
+        value = _pygi_field_layout_get (&cache->fields[i], self, pointer);
+        if (value == NULL) {
+            Py_DECREF (dict);
+            return NULL;
+        }
+        retval = PyDict_SetItem (dict, PyTuple_GET_ITEM (cache->field_names, i),
+                                 value);
+        Py_DECREF (value);
+        if (retval < 0) {
+            Py_DECREF (dict);
+            return NULL;
+        }
+    }
+
+    return dict;
+}
+
+/**
+ * _pygi_struct_update:
+ * @self: a gi.Struct or gi.Boxed instance
+ * @info_type: the type the __info__ of @self has
+ * @kwargs: (allow-none): the new values of the fields, by name
+ *
+ * Returns: None, or %NULL with an exception set
+ */
+PyObject *
+_pygi_struct_update (PyObject *self, PyTypeObject *info_type, PyObject *kwargs)
+{
+    PyGIStructTypeCache *cache;
+    gpointer pointer = pyg_boxed_get (self, void);
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+
+    if (kwargs == NULL)
+        Py_RETURN_NONE;
+
+    cache = _struct_fields_cache (Py_TYPE (self), info_type);
+    if (cache == NULL)
+        return NULL;
+
+    while (PyDict_Next (kwargs, &pos, &key, &value)) {
+        guint i;
+
+        for (i = 0; i < cache->n_fields; i++) {
+            int match;
+
+            match = PyObject_RichCompareBool (key,
+                                              PyTuple_GET_ITEM (cache->field_names, i),
+                                              Py_EQ);
+            if (match < 0)
+                return NULL;
+            if (match)
+                break;
+        }
+
+        if (i == cache->n_fields) {
+            PyObject *repr = PyObject_Repr (key);
+            if (repr != NULL) {
+                PyErr_Format (PyExc_TypeError, "%s has no field %s",
+                              Py_TYPE (self)->tp_name,
+                              PYGLIB_PyUnicode_AsString (repr));
+                Py_DECREF (repr);
+            }
+            return NULL;
+        }
+
+        if (_pygi_field_layout_set (&cache->fields[i], self, pointer, value) < 0)
+            return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * _pygi_struct_from_tuple:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @info_type: the type the __info__ of @type has
+ * @values: a sequence with a value for each field of @type
+ *
+ * Returns: a new instance of @type with its fields set from @values
+ */
+PyObject *
+_pygi_struct_from_tuple (PyTypeObject *type, PyTypeObject *info_type,
+                         PyObject *values)
+{
+    PyGIStructTypeCache *cache;
+    PyObject *seq;
+    PyObject *self = NULL;
+    gpointer pointer;
+    guint i;
+
+    cache = _struct_fields_cache (type, info_type);
+    if (cache == NULL)
+        return NULL;
+
+    seq = PySequence_Fast (values, "values must be a sequence");
+    if (seq == NULL)
+        return NULL;
+
+    if (PySequence_Fast_GET_SIZE (seq) != (Py_ssize_t) cache->n_fields) {
+        PyErr_Format (PyExc_ValueError, "%s has %u fields, got %d values",
+                      type->tp_name, cache->n_fields,
+                      (int) PySequence_Fast_GET_SIZE (seq));
+        goto out;
+    }
+
+    self = PyObject_CallFunctionObjArgs ( (PyObject *) type, NULL);
+    if (self == NULL)
+        goto out;
+    if (_struct_check_instance (type, self) < 0) {
+        Py_CLEAR (self);
+        goto out;
+    }
+
+    pointer = pyg_boxed_get (self, void);
+    for (i = 0; i < cache->n_fields; i++) {
+        if (_pygi_field_layout_set (&cache->fields[i], self, pointer,
+                                    PySequence_Fast_GET_ITEM (seq, i)) < 0) {
+            Py_CLEAR (self);
+            goto out;
+        }
+    }
+
+out:
+    Py_DECREF (seq);
+    return self;
+}
+
+/**
+ * _pygi_struct_as_tuples:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @info_type: the type the __info__ of @type has
+ * @structs: an iterable of instances of @type
+ *
+ * Returns: a list with the as_tuple() of each of @structs
+ */
+PyObject *
+_pygi_struct_as_tuples (PyTypeObject *type, PyTypeObject *info_type,
+                        PyObject *structs)
+{
+    PyGIStructTypeCache *cache;
+    PyObject *seq;
+    PyObject *list;
+    Py_ssize_t i, n;
+
+    cache = _struct_fields_cache (type, info_type);
+    if (cache == NULL)
+        return NULL;
+
+    seq = PySequence_Fast (structs, "structs must be iterable");
+    if (seq == NULL)
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE (seq);
+    list = PyList_New (n);
+    if (list == NULL)
+        goto out;
+
+    for (i = 0; i < n; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM (seq, i);
+        PyObject *tuple;
+
+        if (_struct_check_instance (type, item) < 0) {
+            Py_CLEAR (list);
+            goto out;
+        }
+        tuple = _struct_fields_as_tuple (cache, item);
+        if (tuple == NULL) {
+            Py_CLEAR (list);
+            goto out;
+        }
+        PyList_SET_ITEM (list, i, tuple);
+    }
+
+out:
+    Py_DECREF (seq);
+    return list;
+}
+
+static gboolean
+_struct_check_packable (PyTypeObject *type, PyGIStructTypeCache *cache)
+{
+    if (cache->pack_format == NULL) {
+        PyErr_Format (PyExc_TypeError,
+                      "%s cannot be packed, not all its fields are numbers",
+                      type->tp_name);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * _pygi_struct_get_pack_format:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @info_type: the type the __info__ of @type has
+ *
+ * Returns: the format of the struct module matching what pack() returns
+ * for each instance of @type
+ */
+PyObject *
+_pygi_struct_get_pack_format (PyTypeObject *type, PyTypeObject *info_type)
+{
+    PyGIStructTypeCache *cache;
+
+    cache = _struct_fields_cache (type, info_type);
+    if (cache == NULL || !_struct_check_packable (type, cache))
+        return NULL;
+
+    return PYGLIB_PyUnicode_FromString (cache->pack_format);
+}
+
+/**
+ * _pygi_struct_pack:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @info_type: the type the __info__ of @type has
+ * @structs: an iterable of instances of @type
+ *
+ * Copies the fields of each of @structs one after the other, in native
+ * byte order and without padding, as struct.pack() does with the format
+ * returned by _pygi_struct_get_pack_format().
+ *
+ * Returns: a bytes object
+ */
+PyObject *
+_pygi_struct_pack (PyTypeObject *type, PyTypeObject *info_type,
+                   PyObject *structs)
+{
+    PyGIStructTypeCache *cache;
+    PyObject *seq;
+    PyObject *bytes = NULL;
+    gchar *data;
+    Py_ssize_t i, n;
+
+    cache = _struct_fields_cache (type, info_type);
+    if (cache == NULL || !_struct_check_packable (type, cache))
+        return NULL;
+
+    seq = PySequence_Fast (structs, "structs must be iterable");
+    if (seq == NULL)
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE (seq);
+    bytes = PYGLIB_PyBytes_FromStringAndSize (NULL, n * cache->pack_size);
+    if (bytes == NULL)
+        goto out;
+    data = PYGLIB_PyBytes_AsString (bytes);
+
+    for (i = 0; i < n; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM (seq, i);
+        gpointer pointer;
+        guint j;
+
+        if (_struct_check_instance (type, item) < 0) {
+            Py_CLEAR (bytes);
+            goto out;
+        }
+
+        pointer = pyg_boxed_get (item, void);
+        if (pointer == NULL) {
+            PyErr_SetString (PyExc_ValueError, "structure has no memory");
+            Py_CLEAR (bytes);
+            goto out;
+        }
+
+        for (j = 0; j < cache->n_fields; j++) {
+            gsize size = _pygi_g_type_tag_size (cache->fields[j].type_tag);
+
+            memcpy (data, (gchar *) pointer + cache->fields[j].offset, size);
+            data += size;
+        }
+    }
+
+out:
+    Py_DECREF (seq);
+    return bytes;
+}
+
+/* like PyType_GenericAlloc() */
+static PyObject *
+_struct_freelist_pop (PyGLibFreeList *list, PyTypeObject *type)
+{
+    PyObject *self;
+
+    self = _pyglib_freelist_pop (list, type);
+    if (self == NULL)
+        return NULL;
+
+#if PY_VERSION_HEX < 0x03080000
+    if (type->tp_flags & Py_TPFLAGS_HEAPTYPE)
+        Py_INCREF (type);
+#endif
+    if (PyType_IS_GC (type))
+        PyObject_GC_Track (self);
+
+    return self;
+}
+
+/**
+ * _pygi_struct_alloc:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @cache: the cache of @type, or %NULL
+ *
+ * Allocates an instance of @type, reusing one of the free list of @cache
+ * when there is one.
+ *
+ * Returns: the new instance, or %NULL with an exception set
+ */
+PyObject *
+_pygi_struct_alloc (PyTypeObject *type, PyGIStructTypeCache *cache)
+{
+    PyObject *self = NULL;
+
+    if (cache != NULL && cache->freelist != NULL)
+        self = _struct_freelist_pop (cache->freelist, type);
+    if (self == NULL)
+        self = type->tp_alloc (type, 0);
+
+    return self;
+}
+
+/**
+ * _pygi_struct_inline_alloc:
+ * @type: a gi.Struct or gi.Boxed subclass
+ * @cache: the cache of @type
+ *
+ * Allocates an instance of @type followed by the zeroed structure at
+ * _pygi_inline_storage(), so that a small structure and its wrapper take
+ * a single allocation, released together by _pygi_struct_free().
+ *
+ * Returns: the new instance, or %NULL with no exception set when the
+ * structure cannot be stored inline
+ */
+PyObject *
+_pygi_struct_inline_alloc (PyTypeObject *type, PyGIStructTypeCache *cache)
+{
+#if PY_VERSION_HEX < 0x030B0000
+    PyObject *self;
+    gsize total;
+
+    if (cache->size > PYGI_INLINE_STRUCT_MAX || type->tp_itemsize != 0
+        || type->tp_alloc != PyType_GenericAlloc)
+        return NULL;
+
+    if (cache->inline_freelist != NULL) {
+        self = _struct_freelist_pop (cache->inline_freelist, type);
+        if (self != NULL)
+            return self;
+    }
+
+    /* what PyType_GenericAlloc() does, with room for the structure */
+    total = _PYGI_INLINE_OFFSET (type) + cache->size;
+    if (PyType_IS_GC (type))
+        self = _PyObject_GC_Malloc (total);
+    else
+        self = (PyObject *) PyObject_MALLOC (total);
+    if (self == NULL)
+        return NULL;
+    memset (self, 0, total);
+
+#if PY_VERSION_HEX < 0x03080000
+    if (type->tp_flags & Py_TPFLAGS_HEAPTYPE)
+        Py_INCREF (type);
+#endif
+    PyObject_INIT (self, type);
+
+    if (PyType_IS_GC (type))
+        PyObject_GC_Track (self);
+
+    return self;
+#else
+    /* no public way to allocate extra room in a GC object */
+    return NULL;
+#endif
+}
+
+/**
+ * _pygi_struct_free:
+ * @self: a deallocated, untracked gi.Struct or gi.Boxed instance
+ * @cache: the cache of the type of @self, or %NULL
+ * @pointer: the structure @self wrapped
+ * @free_on_dealloc: whether @self owned it
+ *
+ * Called by tp_dealloc in place of tp_free: hands the memory of @self to
+ * the free list of its size when it has room.
+ */
+void
+_pygi_struct_free (PyObject            *self,
+                   PyGIStructTypeCache *cache,
+                   gpointer             pointer,
+                   gboolean             free_on_dealloc)
+{
+    PyGLibFreeList *list = NULL;
+
+    if (cache != NULL) {
+        /* only instances allocated inline own their inline storage */
+        if (free_on_dealloc && pointer == _pygi_inline_storage (self))
+            list = cache->inline_freelist;
+        else
+            list = cache->freelist;
+    }
+
+    if (list == NULL || !_pyglib_freelist_push (list, self))
+        Py_TYPE (self)->tp_free (self);
+}
+
 static void
 _struct_dealloc (PyGIStruct *self)
 {
-    GIBaseInfo *info = _pygi_object_get_gi_info (
-                           (PyObject *) self,
-                           &PyGIStructInfo_Type);
+    PyGIStructTypeCache *cache;
+    gpointer pointer = ( (PyGPointer *) self)->pointer;
+
+    cache = _pygi_struct_type_cache (Py_TYPE (self), &PyGIStructInfo_Type);
+    if (cache == NULL)
+        PyErr_Clear();
 
     PyObject_GC_UnTrack ( (PyObject *) self);
 
     PyObject_ClearWeakRefs ( (PyObject *) self);
 
-    if (info != NULL && g_struct_info_is_foreign ( (GIStructInfo *) info)) {
-        pygi_struct_foreign_release (info, ( (PyGPointer *) self)->pointer);
-    } else if (self->free_on_dealloc) {
-        g_free ( ( (PyGPointer *) self)->pointer);
+    if (cache != NULL && cache->is_foreign) {
+        pygi_struct_foreign_release (cache->info, pointer);
+    } else if (self->free_on_dealloc && pointer != _pygi_inline_storage (self)) {
+        g_free (pointer);
     }
 
-    g_base_info_unref (info);
-
-    Py_TYPE( (PyGPointer *) self )->tp_free ( (PyObject *) self);
+    _pygi_struct_free ( (PyObject *) self, cache, pointer,
+                        self->free_on_dealloc);
 }
 
 static PyObject *
@@ -56,28 +815,39 @@ _struct_new (PyTypeObject *type,
 {
     static char *kwlist[] = { NULL };
 
-    GIBaseInfo *info;
-    gsize size;
+    PyGIStructTypeCache *cache;
     gpointer pointer;
-    PyObject *self = NULL;
+    PyObject *self;
 
     if (!PyArg_ParseTupleAndKeywords (args, kwargs, "", kwlist)) {
         return NULL;
     }
 
-    info = _pygi_object_get_gi_info ( (PyObject *) type, &PyGIStructInfo_Type);
-    if (info == NULL) {
-        if (PyErr_ExceptionMatches (PyExc_AttributeError)) {
-            PyErr_Format (PyExc_TypeError, "missing introspection information");
-        }
+    cache = _pygi_struct_type_cache (type, &PyGIStructInfo_Type);
+    if (cache == NULL) {
         return NULL;
     }
 
-    size = g_struct_info_get_size ( (GIStructInfo *) info);
-    pointer = g_try_malloc0 (size);
+    /* opaque structures cannot be allocated */
+    if (cache->size == 0) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (!cache->is_foreign) {
+        self = _pygi_struct_inline_alloc (type, cache);
+        if (self != NULL) {
+            ( (PyGPointer *) self)->gtype = cache->g_type;
+            ( (PyGPointer *) self)->pointer = _pygi_inline_storage (self);
+            ( (PyGIStruct *) self)->free_on_dealloc = TRUE;
+            return self;
+        }
+    }
+
+    pointer = g_try_malloc0 (cache->size);
     if (pointer == NULL) {
         PyErr_NoMemory();
-        goto out;
+        return NULL;
     }
 
     self = _pygi_struct_new (type, pointer, TRUE);
@@ -85,9 +855,6 @@ _struct_new (PyTypeObject *type,
         g_free (pointer);
     }
 
-out:
-    g_base_info_unref (info);
-
     return (PyObject *) self;
 }
 
@@ -100,6 +867,62 @@ _struct_init (PyObject *self,
     return 0;
 }
 
+static PyObject *
+_struct_as_tuple (PyObject *self)
+{
+    return _pygi_struct_as_tuple (self, &PyGIStructInfo_Type);
+}
+
+static PyObject *
+_struct_as_dict (PyObject *self)
+{
+    return _pygi_struct_as_dict (self, &PyGIStructInfo_Type);
+}
+
+static PyObject *
+_struct_update (PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    if (!PyArg_ParseTuple (args, ":update"))
+        return NULL;
+
+    return _pygi_struct_update (self, &PyGIStructInfo_Type, kwargs);
+}
+
+static PyObject *
+_struct_from_tuple (PyObject *type, PyObject *values)
+{
+    return _pygi_struct_from_tuple ( (PyTypeObject *) type, &PyGIStructInfo_Type, values);
+}
+
+static PyObject *
+_struct_as_tuples (PyObject *type, PyObject *structs)
+{
+    return _pygi_struct_as_tuples ( (PyTypeObject *) type, &PyGIStructInfo_Type, structs);
+}
+
+static PyObject *
+_struct_get_pack_format (PyObject *type)
+{
+    return _pygi_struct_get_pack_format ( (PyTypeObject *) type, &PyGIStructInfo_Type);
+}
+
+static PyObject *
+_struct_pack (PyObject *type, PyObject *structs)
+{
+    return _pygi_struct_pack ( (PyTypeObject *) type, &PyGIStructInfo_Type, structs);
+}
+
+static PyMethodDef _struct_methods[] = {
+    { "as_tuple", (PyCFunction) _struct_as_tuple, METH_NOARGS },
+    { "as_dict", (PyCFunction) _struct_as_dict, METH_NOARGS },
+    { "update", (PyCFunction) _struct_update, METH_VARARGS | METH_KEYWORDS },
+    { "from_tuple", (PyCFunction) _struct_from_tuple, METH_O | METH_CLASS },
+    { "as_tuples", (PyCFunction) _struct_as_tuples, METH_O | METH_CLASS },
+    { "get_pack_format", (PyCFunction) _struct_get_pack_format, METH_NOARGS | METH_CLASS },
+    { "pack", (PyCFunction) _struct_pack, METH_O | METH_CLASS },
+    { NULL, NULL, 0 }
+};
+
 PYGLIB_DEFINE_TYPE("gi.Struct", PyGIStruct_Type, PyGIStruct);
 
 PyObject *
@@ -108,6 +931,7 @@ _pygi_struct_new (PyTypeObject *type,
                   gboolean      free_on_dealloc)
 {
     PyGIStruct *self;
+    PyGIStructTypeCache *cache;
     GType g_type;
 
     if (!PyType_IsSubtype (type, &PyGIStruct_Type)) {
@@ -115,13 +939,19 @@ _pygi_struct_new (PyTypeObject *type,
         return NULL;
     }
 
-    self = (PyGIStruct *) type->tp_alloc (type, 0);
+    cache = _pygi_struct_type_cache (type, &PyGIStructInfo_Type);
+    if (cache != NULL) {
+        g_type = cache->g_type;
+    } else {
+        PyErr_Clear();
+        g_type = pyg_type_from_object ( (PyObject *) type);
+    }
+
+    self = (PyGIStruct *) _pygi_struct_alloc (type, cache);
     if (self == NULL) {
         return NULL;
     }
 
-    g_type = pyg_type_from_object ( (PyObject *) type);
-
     ( (PyGPointer *) self)->gtype = g_type;
     ( (PyGPointer *) self)->pointer = pointer;
     self->free_on_dealloc = free_on_dealloc;
@@ -137,6 +967,7 @@ _pygi_struct_register_types (PyObject *m)
     PyGIStruct_Type.tp_new = (newfunc) _struct_new;
     PyGIStruct_Type.tp_init = (initproc) _struct_init;
     PyGIStruct_Type.tp_dealloc = (destructor) _struct_dealloc;
+    PyGIStruct_Type.tp_methods = _struct_methods;
     PyGIStruct_Type.tp_flags = (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE);
 
     if (PyType_Ready (&PyGIStruct_Type))
@@ -23,11 +23,75 @@
 #define __PYGI_STRUCT_H__
 
 #include <Python.h>
+#include <pyglib.h>
 
 G_BEGIN_DECLS
 
 extern PyTypeObject PyGIStruct_Type;
 
+/* What gi.Struct and gi.Boxed subclasses need from their introspection
+ * information on every construction, computed once per type. */
+typedef struct {
+    GIBaseInfo *info;
+    GType g_type;
+    gsize size;
+    gboolean is_foreign;
+
+    /* filled by _pygi_struct_type_cache_fields() */
+    guint n_fields;
+    PyGIFieldLayout *fields;
+    PyObject *field_names;
+    gchar *pack_format;
+    gsize pack_size;
+
+    /* deallocated instances of the type, with and without the structure
+     * stored inline; NULL when the type allocates differently */
+    PyGLibFreeList *freelist;
+    PyGLibFreeList *inline_freelist;
+} PyGIStructTypeCache;
+
+/* Structures up to this size are stored inside their wrapper. */
+#define PYGI_INLINE_STRUCT_MAX 256
+
+#define _PYGI_INLINE_OFFSET(type) \
+    (((type)->tp_basicsize + 2 * sizeof (gpointer) - 1) & ~(2 * sizeof (gpointer) - 1))
+#define _pygi_inline_storage(self) \
+    ((gpointer) ((gchar *) (self) + _PYGI_INLINE_OFFSET (Py_TYPE (self))))
+
+PyGIStructTypeCache *_pygi_struct_type_cache (PyTypeObject *type,
+                                              PyTypeObject *info_type);
+PyGIStructTypeCache *_pygi_struct_type_cache_peek (PyTypeObject *type);
+
+PyObject *_pygi_struct_alloc (PyTypeObject        *type,
+                              PyGIStructTypeCache *cache);
+PyObject *_pygi_struct_inline_alloc (PyTypeObject        *type,
+                                     PyGIStructTypeCache *cache);
+void _pygi_struct_free (PyObject            *self,
+                        PyGIStructTypeCache *cache,
+                        gpointer             pointer,
+                        gboolean             free_on_dealloc);
+
+gboolean _pygi_struct_type_cache_fields (PyGIStructTypeCache *cache);
+
+PyObject *_pygi_struct_as_tuple (PyObject     *self,
+                                 PyTypeObject *info_type);
+PyObject *_pygi_struct_as_dict (PyObject     *self,
+                                PyTypeObject *info_type);
+PyObject *_pygi_struct_update (PyObject     *self,
+                               PyTypeObject *info_type,
+                               PyObject     *kwargs);
+PyObject *_pygi_struct_from_tuple (PyTypeObject *type,
+                                   PyTypeObject *info_type,
+                                   PyObject     *values);
+PyObject *_pygi_struct_as_tuples (PyTypeObject *type,
+                                  PyTypeObject *info_type,
+                                  PyObject     *structs);
+PyObject *_pygi_struct_get_pack_format (PyTypeObject *type,
+                                        PyTypeObject *info_type);
+PyObject *_pygi_struct_pack (PyTypeObject *type,
+                             PyTypeObject *info_type,
+                             PyObject     *structs);
+
 PyObject *
 _pygi_struct_new (PyTypeObject *type,
                   gpointer      pointer,
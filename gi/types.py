@@ -30,6 +30,7 @@ from ._gi import \
     ObjectInfo, \
     StructInfo, \
     VFuncInfo, \
+    FieldDescriptor, \
     set_object_has_new_constructor, \
     register_interface_info, \
     hook_up_vfunc_implementation
@@ -40,8 +41,8 @@ if sys.version_info > (3, 0):
 
 def Function(info):
 
-    def function(*args):
-        return info.invoke(*args)
+    def function(*args, **kwargs):
+        return info.invoke(*args, **kwargs)
     function.__info__ = info
     function.__name__ = info.get_name()
     function.__module__ = info.get_namespace()
@@ -51,8 +52,9 @@ def Function(info):
 
 def NativeVFunc(info, cls):
 
-    def native_vfunc(*args):
-        return info.invoke(*args, **dict(gtype=cls.__gtype__))
+    def native_vfunc(*args, **kwargs):
+        kwargs['gtype'] = cls.__gtype__
+        return info.invoke(*args, **kwargs)
     native_vfunc.__info__ = info
     native_vfunc.__name__ = info.get_name()
     native_vfunc.__module__ = info.get_namespace()
@@ -98,7 +100,7 @@ class MetaClassHelper(object):
     def _setup_fields(cls):
         for field_info in cls.__info__.get_fields():
             name = field_info.get_name().replace('-', '_')
-            setattr(cls, name, property(field_info.get_value, field_info.set_value))
+            setattr(cls, name, FieldDescriptor(cls, field_info))
 
     def _setup_constants(cls):
         for constant_info in cls.__info__.get_constants():
@@ -38,3 +38,39 @@ _install_file_meta(GFileMeta)
 class GAppInfoMeta(GObjectMeta):
     __call__ = _app_info_init
 _install_app_info_meta(GAppInfoMeta)
+
+def _input_stream_iter_chunks(self, chunk_size=8192, cancellable=None):
+    """S.iter_chunks([chunk_size, [cancellable]]) -> iterator
+
+    Reads the stream until the end, yielding memoryviews of at most
+    chunk_size bytes.  All chunks share one buffer, so a chunk is only
+    valid until the next one is requested; copy it with bytes() to keep it.
+    """
+    buf = bytearray(chunk_size)
+    view = memoryview(buf)
+    while True:
+        count = self.readinto(buf, cancellable)
+        if not count:
+            break
+        yield view[:count]
+InputStream.iter_chunks = _input_stream_iter_chunks
+
+gather = Future.gather
+
+def future(method, *args, **kwargs):
+    """future(obj.method_async, *args, **kwargs) -> gio.Future
+
+    Starts an asynchronous operation with a gio.Future as its callback.
+    The future calls the matching method_finish() itself once the
+    operation completes, so it can be awaited, passed to gio.gather()
+    or queried with result().  Arguments that follow the callback in
+    the method signature must be given as keywords.  If a cancellable is
+    passed, cancelling the future cancels the operation too.
+    """
+    name = method.__name__
+    if not name.endswith('_async'):
+        raise ValueError('%s is not an asynchronous method' % name)
+    finish = getattr(method.__self__, name[:-len('_async')] + '_finish')
+    result = Future(finish, kwargs.get('cancellable'))
+    method(callback=result, *args, **kwargs)
+    return result
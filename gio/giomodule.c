@@ -34,6 +34,8 @@
 
 #include <gio/gio.h>
 
+#include "pygio-future.h"
+
 #define PYGIO_MAJOR_VERSION PYGOBJECT_MAJOR_VERSION
 #define PYGIO_MINOR_VERSION PYGOBJECT_MINOR_VERSION
 #define PYGIO_MICRO_VERSION PYGOBJECT_MICRO_VERSION
@@ -62,6 +64,7 @@ PYGLIB_INIT_FUNCTION(_gio, "gio._gio", pygio_functions)
         return -1;
 
     pygio_register_classes(d);
+    pygio_future_register_types(d);
     pygio_add_constants(module, "G_IO_");
 
     PyModule_AddStringConstant(module, "ERROR", g_quark_to_string(G_IO_ERROR));
@@ -0,0 +1,863 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * pygobject - Python bindings for the GObject library
+ *
+ *   pygio-future.c: awaitable results of gio async operations
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301
+ * USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "pygio-utils.h"
+#include "pygio-future.h"
+#include <pyglib-python-compat.h>
+
+/* A gio.Future is passed as the callback of any *_async() method.  When
+ * the operation completes, async_result_callback_marshal() hands the
+ * GAsyncResult straight to pygio_future_complete(), which calls the
+ * matching *_finish() and stores its return value or exception.
+ *
+ * Futures follow the asyncio future protocol (done callbacks, result(),
+ * _asyncio_future_blocking, get_loop()) so coroutines can await them,
+ * and Future.gather() completes from C once all of its children have,
+ * without a Python callback per child. */
+
+typedef enum {
+    PYGIO_FUTURE_PENDING,
+    PYGIO_FUTURE_FINISHED,
+    PYGIO_FUTURE_CANCELLED
+} PyGIOFutureState;
+
+typedef struct {
+    PyObject_HEAD
+    PyGIOFutureState state;
+    gboolean blocking;
+    PyObject *finish;
+    PyObject *cancellable;
+    PyObject *loop;
+    PyObject *result;
+    PyObject *exception;
+    /* list of (callback, context) tuples */
+    PyObject *callbacks;
+    /* gather futures waiting for this one */
+    PyObject *parents;
+    /* set on gather futures only */
+    PyObject *children;
+    Py_ssize_t n_pending;
+    gboolean return_exceptions;
+} PyGIOFuture;
+
+static PyObject *
+pygio_future_asyncio_attr(const char *name)
+{
+    PyObject *module, *attr;
+
+    module = PyImport_ImportModule("asyncio");
+    if (module == NULL)
+        return NULL;
+
+    attr = PyObject_GetAttrString(module, name);
+    Py_DECREF(module);
+    return attr;
+}
+
+static void
+pygio_future_set_asyncio_error(const char *name, const char *message)
+{
+    PyObject *type = pygio_future_asyncio_attr(name);
+
+    if (type == NULL)
+        return;
+
+    if (message)
+        PyErr_SetString(type, message);
+    else
+        PyErr_SetNone(type);
+    Py_DECREF(type);
+}
+
+/* Takes the current exception as an instance with its traceback. */
+static PyObject *
+pygio_future_fetch_exception(void)
+{
+    PyObject *type, *value, *traceback;
+
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+    if (traceback) {
+        PyException_SetTraceback(value, traceback);
+        Py_DECREF(traceback);
+    }
+    Py_DECREF(type);
+
+    return value;
+}
+
+static void pygio_future_child_done(PyGIOFuture *self, PyGIOFuture *child);
+
+/* Runs once the future leaves the pending state: completes the gather
+ * futures waiting on it, then runs or schedules its done callbacks. */
+static void
+pygio_future_schedule_callbacks(PyGIOFuture *self)
+{
+    PyObject *parents = self->parents, *callbacks = self->callbacks;
+    Py_ssize_t i;
+
+    self->parents = NULL;
+    self->callbacks = NULL;
+
+    if (parents) {
+        for (i = 0; i < PyList_GET_SIZE(parents); i++)
+            pygio_future_child_done(
+                (PyGIOFuture *) PyList_GET_ITEM(parents, i), self);
+        Py_DECREF(parents);
+    }
+
+    if (callbacks == NULL)
+        return;
+
+    for (i = 0; i < PyList_GET_SIZE(callbacks); i++) {
+        PyObject *item = PyList_GET_ITEM(callbacks, i);
+        PyObject *callback = PyTuple_GET_ITEM(item, 0);
+        PyObject *context = PyTuple_GET_ITEM(item, 1);
+        PyObject *ret;
+
+        if (self->loop) {
+            PyObject *call_soon, *args, *kwargs = NULL;
+
+            call_soon = PyObject_GetAttrString(self->loop, "call_soon");
+            if (call_soon == NULL) {
+                PyErr_Print();
+                continue;
+            }
+            args = Py_BuildValue("(OO)", callback, self);
+            if (context != Py_None)
+                kwargs = Py_BuildValue("{sO}", "context", context);
+            ret = PyObject_Call(call_soon, args, kwargs);
+            Py_DECREF(call_soon);
+            Py_DECREF(args);
+            Py_XDECREF(kwargs);
+        } else
+            ret = PyObject_CallFunctionObjArgs(callback, self, NULL);
+
+        if (ret == NULL)
+            PyErr_Print();
+        Py_XDECREF(ret);
+    }
+
+    Py_DECREF(callbacks);
+}
+
+/* Settles a pending future; steals the references to result and
+ * exception, exactly one of which is non-NULL. */
+static void
+pygio_future_settle(PyGIOFuture *self, PyObject *result, PyObject *exception)
+{
+    if (self->state != PYGIO_FUTURE_PENDING) {
+        Py_XDECREF(result);
+        Py_XDECREF(exception);
+        return;
+    }
+
+    self->state = PYGIO_FUTURE_FINISHED;
+    self->result = result;
+    self->exception = exception;
+    pygio_future_schedule_callbacks(self);
+}
+
+static PyObject *
+pygio_future_cancelled_error(void)
+{
+    PyObject *type, *exception;
+
+    type = pygio_future_asyncio_attr("CancelledError");
+    if (type == NULL)
+        return pygio_future_fetch_exception();
+
+    exception = PyObject_CallFunctionObjArgs(type, NULL);
+    Py_DECREF(type);
+    if (exception == NULL)
+        return pygio_future_fetch_exception();
+    return exception;
+}
+
+static void
+pygio_future_child_done(PyGIOFuture *self, PyGIOFuture *child)
+{
+    PyObject *results;
+    Py_ssize_t i;
+
+    if (self->state != PYGIO_FUTURE_PENDING)
+        return;
+
+    if (!self->return_exceptions) {
+        if (child->state == PYGIO_FUTURE_CANCELLED) {
+            pygio_future_settle(self, NULL, pygio_future_cancelled_error());
+            return;
+        }
+        if (child->exception) {
+            Py_INCREF(child->exception);
+            pygio_future_settle(self, NULL, child->exception);
+            return;
+        }
+    }
+
+    if (--self->n_pending > 0)
+        return;
+
+    results = PyList_New(PyList_GET_SIZE(self->children));
+    if (results == NULL) {
+        pygio_future_settle(self, NULL, pygio_future_fetch_exception());
+        return;
+    }
+
+    for (i = 0; i < PyList_GET_SIZE(self->children); i++) {
+        PyGIOFuture *item = (PyGIOFuture *) PyList_GET_ITEM(self->children, i);
+        PyObject *value;
+
+        if (item->state == PYGIO_FUTURE_CANCELLED)
+            value = pygio_future_cancelled_error();
+        else {
+            value = item->exception ? item->exception : item->result;
+            Py_INCREF(value);
+        }
+        PyList_SET_ITEM(results, i, value);
+    }
+
+    pygio_future_settle(self, results, NULL);
+}
+
+/* Calls the *_finish() method on the result of the operation. */
+static void
+pygio_future_finish(PyGIOFuture *self, PyObject *pyresult)
+{
+    PyObject *ret;
+
+    if (self->state != PYGIO_FUTURE_PENDING)
+        return;
+
+    if (self->finish == NULL) {
+        Py_INCREF(pyresult);
+        pygio_future_settle(self, pyresult, NULL);
+        return;
+    }
+
+    ret = PyObject_CallFunctionObjArgs(self->finish, pyresult, NULL);
+    if (ret == NULL)
+        pygio_future_settle(self, NULL, pygio_future_fetch_exception());
+    else
+        pygio_future_settle(self, ret, NULL);
+}
+
+void
+pygio_future_complete(PyObject *future,
+                      GObject *source_object,
+                      GAsyncResult *result)
+{
+    PyGIOFuture *self = (PyGIOFuture *) future;
+    PyObject *pyresult;
+
+    if (self->state != PYGIO_FUTURE_PENDING)
+        return;
+
+    pyresult = pygobject_new((GObject *) result);
+    if (pyresult == NULL) {
+        pygio_future_settle(self, NULL, pygio_future_fetch_exception());
+        return;
+    }
+
+    pygio_future_finish(self, pyresult);
+    Py_DECREF(pyresult);
+}
+
+static int
+pygio_future_init(PyGIOFuture *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "finish", "cancellable", "loop", NULL };
+    PyObject *finish = NULL, *pycancellable = NULL, *loop = NULL;
+    GCancellable *cancellable;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     "|OOO:gio.Future.__init__", kwlist,
+                                     &finish, &pycancellable, &loop))
+        return -1;
+
+    if (finish == Py_None)
+        finish = NULL;
+    if (finish && !PyCallable_Check(finish)) {
+        PyErr_SetString(PyExc_TypeError, "finish argument not callable");
+        return -1;
+    }
+
+    if (!pygio_check_cancellable((PyGObject *) pycancellable, &cancellable))
+        return -1;
+    if (cancellable == NULL)
+        pycancellable = NULL;
+
+    if (loop == Py_None)
+        loop = NULL;
+
+    Py_XINCREF(finish);
+    Py_CLEAR(self->finish);
+    self->finish = finish;
+    Py_XINCREF(pycancellable);
+    Py_CLEAR(self->cancellable);
+    self->cancellable = pycancellable;
+    Py_XINCREF(loop);
+    Py_CLEAR(self->loop);
+    self->loop = loop;
+
+    return 0;
+}
+
+static int
+pygio_future_traverse(PyGIOFuture *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->finish);
+    Py_VISIT(self->cancellable);
+    Py_VISIT(self->loop);
+    Py_VISIT(self->result);
+    Py_VISIT(self->exception);
+    Py_VISIT(self->callbacks);
+    Py_VISIT(self->parents);
+    Py_VISIT(self->children);
+    return 0;
+}
+
+static int
+pygio_future_clear(PyGIOFuture *self)
+{
+    Py_CLEAR(self->finish);
+    Py_CLEAR(self->cancellable);
+    Py_CLEAR(self->loop);
+    Py_CLEAR(self->result);
+    Py_CLEAR(self->exception);
+    Py_CLEAR(self->callbacks);
+    Py_CLEAR(self->parents);
+    Py_CLEAR(self->children);
+    return 0;
+}
+
+static void
+pygio_future_dealloc(PyGIOFuture *self)
+{
+    PyObject_GC_UnTrack((PyObject *) self);
+    pygio_future_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static PyObject *
+pygio_future_repr(PyGIOFuture *self)
+{
+    const char *state;
+
+    switch (self->state) {
+    case PYGIO_FUTURE_PENDING:
+        state = "pending";
+        break;
+    case PYGIO_FUTURE_CANCELLED:
+        state = "cancelled";
+        break;
+    default:
+        state = self->exception ? "failed" : "finished";
+        break;
+    }
+
+    return PYGLIB_PyUnicode_FromFormat("<gio.Future %s at %p>", state, self);
+}
+
+/* Lets a future be used where a GAsyncReadyCallback-style Python
+ * callback is expected: future(source_object, result[, user_data]). */
+static PyObject *
+pygio_future_call(PyGIOFuture *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *source, *pyresult, *data = NULL;
+
+    if (!PyArg_ParseTuple(args, "OO|O:gio.Future.__call__",
+                          &source, &pyresult, &data))
+        return NULL;
+
+    pygio_future_finish(self, pyresult);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pygio_future_done(PyGIOFuture *self)
+{
+    return PyBool_FromLong(self->state != PYGIO_FUTURE_PENDING);
+}
+
+static PyObject *
+pygio_future_cancelled(PyGIOFuture *self)
+{
+    return PyBool_FromLong(self->state == PYGIO_FUTURE_CANCELLED);
+}
+
+static PyObject *
+pygio_future_result(PyGIOFuture *self)
+{
+    switch (self->state) {
+    case PYGIO_FUTURE_PENDING:
+        pygio_future_set_asyncio_error("InvalidStateError",
+                                       "Result is not ready.");
+        return NULL;
+    case PYGIO_FUTURE_CANCELLED:
+        pygio_future_set_asyncio_error("CancelledError", NULL);
+        return NULL;
+    default:
+        break;
+    }
+
+    if (self->exception) {
+        PyErr_SetObject((PyObject *) Py_TYPE(self->exception),
+                        self->exception);
+        return NULL;
+    }
+
+    Py_INCREF(self->result);
+    return self->result;
+}
+
+static PyObject *
+pygio_future_exception(PyGIOFuture *self)
+{
+    switch (self->state) {
+    case PYGIO_FUTURE_PENDING:
+        pygio_future_set_asyncio_error("InvalidStateError",
+                                       "Exception is not set.");
+        return NULL;
+    case PYGIO_FUTURE_CANCELLED:
+        pygio_future_set_asyncio_error("CancelledError", NULL);
+        return NULL;
+    default:
+        break;
+    }
+
+    if (self->exception == NULL) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    Py_INCREF(self->exception);
+    return self->exception;
+}
+
+static PyObject *
+pygio_future_add_done_callback(PyGIOFuture *self,
+                               PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "fn", "context", NULL };
+    PyObject *callback, *context = Py_None, *item;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     "O|O:gio.Future.add_done_callback",
+                                     kwlist, &callback, &context))
+        return NULL;
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "fn argument not callable");
+        return NULL;
+    }
+
+    if (self->callbacks == NULL) {
+        self->callbacks = PyList_New(0);
+        if (self->callbacks == NULL)
+            return NULL;
+    }
+
+    item = PyTuple_Pack(2, callback, context);
+    if (item == NULL || PyList_Append(self->callbacks, item) < 0) {
+        Py_XDECREF(item);
+        return NULL;
+    }
+    Py_DECREF(item);
+
+    if (self->state != PYGIO_FUTURE_PENDING)
+        pygio_future_schedule_callbacks(self);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pygio_future_remove_done_callback(PyGIOFuture *self, PyObject *callback)
+{
+    PyObject *callbacks;
+    Py_ssize_t i, removed = 0;
+
+    if (self->callbacks == NULL)
+        return PyLong_FromSsize_t(0);
+
+    callbacks = PyList_New(0);
+    if (callbacks == NULL)
+        return NULL;
+
+    for (i = 0; i < PyList_GET_SIZE(self->callbacks); i++) {
+        PyObject *item = PyList_GET_ITEM(self->callbacks, i);
+        int equal;
+
+        equal = PyObject_RichCompareBool(PyTuple_GET_ITEM(item, 0),
+                                         callback, Py_EQ);
+        if (equal < 0 || (!equal && PyList_Append(callbacks, item) < 0)) {
+            Py_DECREF(callbacks);
+            return NULL;
+        }
+        if (equal)
+            removed++;
+    }
+
+    Py_DECREF(self->callbacks);
+    self->callbacks = callbacks;
+
+    return PyLong_FromSsize_t(removed);
+}
+
+static gboolean
+pygio_future_cancel_internal(PyGIOFuture *self)
+{
+    Py_ssize_t i;
+
+    if (self->state != PYGIO_FUTURE_PENDING)
+        return FALSE;
+
+    self->state = PYGIO_FUTURE_CANCELLED;
+
+    if (self->cancellable)
+        g_cancellable_cancel(
+            G_CANCELLABLE(pygobject_get(self->cancellable)));
+
+    if (self->children) {
+        for (i = 0; i < PyList_GET_SIZE(self->children); i++)
+            pygio_future_cancel_internal(
+                (PyGIOFuture *) PyList_GET_ITEM(self->children, i));
+    }
+
+    pygio_future_schedule_callbacks(self);
+    return TRUE;
+}
+
+static PyObject *
+pygio_future_cancel(PyGIOFuture *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "msg", NULL };
+    PyObject *msg = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:gio.Future.cancel",
+                                     kwlist, &msg))
+        return NULL;
+
+    return PyBool_FromLong(pygio_future_cancel_internal(self));
+}
+
+static PyObject *
+pygio_future_set_result(PyGIOFuture *self, PyObject *result)
+{
+    if (self->state != PYGIO_FUTURE_PENDING) {
+        pygio_future_set_asyncio_error("InvalidStateError",
+                                       "Future is already done.");
+        return NULL;
+    }
+
+    Py_INCREF(result);
+    pygio_future_settle(self, result, NULL);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pygio_future_set_exception(PyGIOFuture *self, PyObject *exception)
+{
+    if (self->state != PYGIO_FUTURE_PENDING) {
+        pygio_future_set_asyncio_error("InvalidStateError",
+                                       "Future is already done.");
+        return NULL;
+    }
+
+    if (PyType_Check(exception)) {
+        exception = PyObject_CallFunctionObjArgs(exception, NULL);
+        if (exception == NULL)
+            return NULL;
+    } else
+        Py_INCREF(exception);
+
+    if (!PyExceptionInstance_Check(exception)) {
+        Py_DECREF(exception);
+        PyErr_SetString(PyExc_TypeError,
+                        "exception must be an exception instance or class");
+        return NULL;
+    }
+
+    pygio_future_settle(self, NULL, exception);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pygio_future_get_loop(PyGIOFuture *self)
+{
+    if (self->loop == NULL) {
+        PyObject *get_event_loop;
+
+        get_event_loop = pygio_future_asyncio_attr("get_event_loop");
+        if (get_event_loop == NULL)
+            return NULL;
+        self->loop = PyObject_CallFunctionObjArgs(get_event_loop, NULL);
+        Py_DECREF(get_event_loop);
+        if (self->loop == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(self->loop);
+    return self->loop;
+}
+
+static PyObject *
+pygio_future_gather(PyObject *unused, PyObject *args, PyObject *kwargs)
+{
+    PyGIOFuture *self;
+    PyObject *return_exceptions = NULL;
+    Py_ssize_t i, n_children;
+
+    if (kwargs) {
+        return_exceptions = PyDict_GetItemString(kwargs, "return_exceptions");
+        if (PyDict_Size(kwargs) > (return_exceptions ? 1 : 0)) {
+            PyErr_SetString(PyExc_TypeError, "gio.Future.gather() only "
+                            "accepts the return_exceptions keyword");
+            return NULL;
+        }
+    }
+
+    n_children = PyTuple_GET_SIZE(args);
+    for (i = 0; i < n_children; i++) {
+        if (!PyGIOFuture_Check(PyTuple_GET_ITEM(args, i))) {
+            PyErr_SetString(PyExc_TypeError,
+                            "gio.Future.gather() takes gio.Future objects");
+            return NULL;
+        }
+    }
+
+    self = (PyGIOFuture *) PyType_GenericNew(&PyGIOFuture_Type, NULL, NULL);
+    if (self == NULL)
+        return NULL;
+
+    self->return_exceptions = return_exceptions
+        && PyObject_IsTrue(return_exceptions);
+    self->n_pending = n_children;
+    self->children = PySequence_List(args);
+    if (self->children == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    if (n_children == 0) {
+        pygio_future_settle(self, PyList_New(0), NULL);
+        return (PyObject *) self;
+    }
+
+    for (i = 0; i < n_children; i++) {
+        PyGIOFuture *child = (PyGIOFuture *) PyTuple_GET_ITEM(args, i);
+
+        if (child->state != PYGIO_FUTURE_PENDING) {
+            pygio_future_child_done(self, child);
+            continue;
+        }
+
+        if (child->parents == NULL) {
+            child->parents = PyList_New(0);
+            if (child->parents == NULL) {
+                Py_DECREF(self);
+                return NULL;
+            }
+        }
+        if (PyList_Append(child->parents, (PyObject *) self) < 0) {
+            Py_DECREF(self);
+            return NULL;
+        }
+    }
+
+    return (PyObject *) self;
+}
+
+/* Awaiting a future yields the future itself until it is done, which is
+ * what asyncio tasks expect from the objects they wait on. */
+static PyObject *
+pygio_future_await(PyGIOFuture *self)
+{
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+static PyObject *
+pygio_future_iternext(PyGIOFuture *self)
+{
+    PyObject *result, *stop;
+
+    if (self->state == PYGIO_FUTURE_PENDING) {
+        self->blocking = TRUE;
+        Py_INCREF(self);
+        return (PyObject *) self;
+    }
+
+    result = pygio_future_result(self);
+    if (result == NULL)
+        return NULL;
+
+    stop = PyObject_CallFunctionObjArgs(PyExc_StopIteration, result, NULL);
+    Py_DECREF(result);
+    if (stop != NULL) {
+        PyErr_SetObject(PyExc_StopIteration, stop);
+        Py_DECREF(stop);
+    }
+    return NULL;
+}
+
+static PyObject *
+pygio_future_send(PyGIOFuture *self, PyObject *value)
+{
+    return pygio_future_iternext(self);
+}
+
+static PyObject *
+pygio_future_throw(PyGIOFuture *self, PyObject *args)
+{
+    PyObject *type, *value = NULL, *traceback = NULL;
+
+    if (!PyArg_ParseTuple(args, "O|OO:gio.Future.throw",
+                          &type, &value, &traceback))
+        return NULL;
+
+    if (PyExceptionInstance_Check(type))
+        PyErr_SetObject((PyObject *) Py_TYPE(type), type);
+    else
+        PyErr_SetObject(type, value);
+    return NULL;
+}
+
+static PyObject *
+pygio_future_get_blocking(PyGIOFuture *self, void *closure)
+{
+    return PyBool_FromLong(self->blocking);
+}
+
+static int
+pygio_future_set_blocking(PyGIOFuture *self, PyObject *value, void *closure)
+{
+    int blocking;
+
+    if (value == NULL) {
+        PyErr_SetString(PyExc_AttributeError, "cannot delete attribute");
+        return -1;
+    }
+
+    blocking = PyObject_IsTrue(value);
+    if (blocking < 0)
+        return -1;
+
+    self->blocking = blocking;
+    return 0;
+}
+
+static PyMethodDef pygio_future_methods[] = {
+    { "done", (PyCFunction)pygio_future_done, METH_NOARGS },
+    { "cancelled", (PyCFunction)pygio_future_cancelled, METH_NOARGS },
+    { "result", (PyCFunction)pygio_future_result, METH_NOARGS },
+    { "exception", (PyCFunction)pygio_future_exception, METH_NOARGS },
+    { "add_done_callback", (PyCFunction)pygio_future_add_done_callback,
+      METH_VARARGS|METH_KEYWORDS },
+    { "remove_done_callback", (PyCFunction)pygio_future_remove_done_callback,
+      METH_O },
+    { "cancel", (PyCFunction)pygio_future_cancel, METH_VARARGS|METH_KEYWORDS },
+    { "set_result", (PyCFunction)pygio_future_set_result, METH_O },
+    { "set_exception", (PyCFunction)pygio_future_set_exception, METH_O },
+    { "get_loop", (PyCFunction)pygio_future_get_loop, METH_NOARGS },
+    { "gather", (PyCFunction)pygio_future_gather,
+      METH_VARARGS|METH_KEYWORDS|METH_STATIC },
+    { "send", (PyCFunction)pygio_future_send, METH_O },
+    { "throw", (PyCFunction)pygio_future_throw, METH_VARARGS },
+    { "__await__", (PyCFunction)pygio_future_await, METH_NOARGS },
+    { NULL, NULL, 0 }
+};
+
+static PyGetSetDef pygio_future_getsets[] = {
+    { "_asyncio_future_blocking", (getter)pygio_future_get_blocking,
+      (setter)pygio_future_set_blocking },
+    { NULL, (getter)0, (setter)0 },
+};
+
+static PyAsyncMethods pygio_future_as_async = {
+    (unaryfunc)pygio_future_await,      /* am_await */
+    (unaryfunc)0,                       /* am_aiter */
+    (unaryfunc)0,                       /* am_anext */
+};
+
+PyTypeObject PyGIOFuture_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "gio.Future",                       /* tp_name */
+    sizeof(PyGIOFuture),                /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    /* methods */
+    (destructor)pygio_future_dealloc,   /* tp_dealloc */
+    (printfunc)0,                       /* tp_print */
+    (getattrfunc)0,                     /* tp_getattr */
+    (setattrfunc)0,                     /* tp_setattr */
+    &pygio_future_as_async,             /* tp_as_async */
+    (reprfunc)pygio_future_repr,        /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    (hashfunc)0,                        /* tp_hash */
+    (ternaryfunc)pygio_future_call,     /* tp_call */
+    (reprfunc)0,                        /* tp_str */
+    (getattrofunc)0,                    /* tp_getattro */
+    (setattrofunc)0,                    /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, /* tp_flags */
+    "Result of a gio asynchronous operation", /* Documentation string */
+    (traverseproc)pygio_future_traverse, /* tp_traverse */
+    (inquiry)pygio_future_clear,        /* tp_clear */
+    (richcmpfunc)0,                     /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    (getiterfunc)pygio_future_await,    /* tp_iter */
+    (iternextfunc)pygio_future_iternext, /* tp_iternext */
+    pygio_future_methods,               /* tp_methods */
+    0,                                  /* tp_members */
+    pygio_future_getsets,               /* tp_getset */
+    NULL,                               /* tp_base */
+    NULL,                               /* tp_dict */
+    (descrgetfunc)0,                    /* tp_descr_get */
+    (descrsetfunc)0,                    /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    (initproc)pygio_future_init,        /* tp_init */
+    (allocfunc)0,                       /* tp_alloc */
+    PyType_GenericNew,                  /* tp_new */
+};
+
+void
+pygio_future_register_types(PyObject *d)
+{
+    if (PyType_Ready(&PyGIOFuture_Type) < 0) {
+        g_return_if_reached();
+    }
+    if (PyDict_SetItemString(d, "Future", (PyObject *)&PyGIOFuture_Type) < 0) {
+        g_return_if_reached();
+    }
+}
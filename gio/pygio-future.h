@@ -0,0 +1,38 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * pygobject - Python bindings for the GObject library
+ *
+ *   pygio-future.h: awaitable results of gio async operations
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301
+ * USA
+ */
+
+#ifndef __PYGIO_FUTURE_H__
+#define __PYGIO_FUTURE_H__
+
+#include <Python.h>
+#include <gio/gio.h>
+
+extern PyTypeObject PyGIOFuture_Type;
+
+#define PyGIOFuture_Check(o) PyObject_TypeCheck(o, &PyGIOFuture_Type)
+
+void pygio_future_complete(PyObject *future,
+                           GObject *source_object,
+                           GAsyncResult *result);
+
+void pygio_future_register_types(PyObject *d);
+
+#endif /* __PYGIO_FUTURE_H__ */
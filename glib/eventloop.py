@@ -0,0 +1,220 @@
+# -*- Mode: Python -*-
+# pygobject - Python bindings for the GObject library
+#
+#   glib/eventloop.py: asyncio event loop running on a GMainContext
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301
+# USA
+
+"""asyncio event loop running on a GLib main context.
+
+    import asyncio
+    import glib.eventloop
+
+    asyncio.set_event_loop_policy(glib.eventloop.EventLoopPolicy())
+
+Ready callbacks, timers, fd readers and writers and the signals GLib can
+watch are all kept by one glib.EventLoopSource attached to the loop's
+main context.  asyncio callbacks and GLib sources are then dispatched by
+the same thread from the same poll(), with no second loop to hand work
+over to.
+"""
+
+import asyncio
+import signal
+import threading
+
+from asyncio import base_events, events
+
+import glib
+
+__all__ = ['EventLoop', 'EventLoopPolicy']
+
+
+def _fileno(fileobj):
+    if isinstance(fileobj, int):
+        return fileobj
+    return int(fileobj.fileno())
+
+
+class EventLoop(asyncio.SelectorEventLoop):
+    """An asyncio event loop dispatched by a glib.MainContext.
+
+    The loop runs on the given context, or on the default main context.
+    While it runs, the context is the thread default one, so GIO
+    asynchronous operations started from coroutines complete on it too.
+    Signals GLib cannot watch (SIGCHLD for instance) fall back to the
+    wakeup fd used by the standard asyncio loop.
+    """
+
+    def __init__(self, context=None):
+        # executors and call_soon_threadsafe() need the GIL released
+        # while the context polls
+        glib.threads_init()
+        self._context = context or glib.main_context_default()
+        self._source = glib.EventLoopSource()
+        self._source.attach(self._context)
+        self._glib_signals = {}
+        super(EventLoop, self).__init__()
+
+    def get_context(self):
+        return self._context
+
+    def time(self):
+        return self._source.time()
+
+    def run_forever(self):
+        self._context.push_thread_default()
+        try:
+            super(EventLoop, self).run_forever()
+        finally:
+            self._context.pop_thread_default()
+
+    def _run_once(self):
+        # the source dispatches everything that is ready; only block when
+        # nobody asked the loop to stop
+        self._context.iteration(not self._stopping)
+
+    def close(self):
+        if self.is_running():
+            raise RuntimeError("Cannot close a running event loop")
+        if self.is_closed():
+            return
+        for sig in list(self._glib_signals):
+            self.remove_signal_handler(sig)
+        super(EventLoop, self).close()
+        self._source.clear()
+        self._source.destroy()
+
+    # callbacks and timers
+
+    def _call_soon(self, callback, args, context):
+        handle = events.Handle(callback, args, self, context)
+        if handle._source_traceback:
+            del handle._source_traceback[-1]
+        self._source.call_soon(handle)
+        return handle
+
+    def _add_callback(self, handle):
+        if not handle._cancelled:
+            self._source.call_soon(handle)
+
+    def _write_to_self(self):
+        # pushing to the source already woke the context up
+        pass
+
+    def call_at(self, when, callback, *args, context=None):
+        self._check_closed()
+        if self._debug:
+            self._check_thread()
+            self._check_callback(callback, 'call_at')
+        timer = events.TimerHandle(when, callback, args, self, context)
+        if timer._source_traceback:
+            del timer._source_traceback[-1]
+        self._source.call_at(when, timer)
+        timer._scheduled = True
+        return timer
+
+    def _timer_handle_cancelled(self, handle):
+        super(EventLoop, self)._timer_handle_cancelled(handle)
+        # cancelled timers stay in the heap until they expire; drop them
+        # once they make up most of it, as asyncio does for its own heap
+        count = self._timer_cancelled_count
+        if (count > base_events._MIN_SCHEDULED_TIMER_HANDLES and
+                count > len(self._source) *
+                base_events._MIN_CANCELLED_TIMER_HANDLES_FRACTION):
+            self._source.purge_cancelled()
+            self._timer_cancelled_count = 0
+
+    # file descriptors
+
+    def _add_reader(self, fd, callback, *args):
+        self._check_closed()
+        handle = events.Handle(callback, args, self, None)
+        old = self._source.add_reader(_fileno(fd), handle)
+        if old is not None:
+            old.cancel()
+        return handle
+
+    def _remove_reader(self, fd):
+        if self.is_closed():
+            return False
+        old = self._source.remove_reader(_fileno(fd))
+        if old is None:
+            return False
+        old.cancel()
+        return True
+
+    def _add_writer(self, fd, callback, *args):
+        self._check_closed()
+        handle = events.Handle(callback, args, self, None)
+        old = self._source.add_writer(_fileno(fd), handle)
+        if old is not None:
+            old.cancel()
+        return handle
+
+    def _remove_writer(self, fd):
+        if self.is_closed():
+            return False
+        old = self._source.remove_writer(_fileno(fd))
+        if old is None:
+            return False
+        old.cancel()
+        return True
+
+    # signals
+
+    def add_signal_handler(self, sig, callback, *args):
+        if (asyncio.iscoroutine(callback) or
+                asyncio.iscoroutinefunction(callback)):
+            raise TypeError("coroutines cannot be used "
+                            "with add_signal_handler()")
+        self._check_signal(sig)
+        self._check_closed()
+
+        handle = events.Handle(callback, args, self, None)
+        try:
+            self._source.add_signal(sig, handle)
+        except ValueError:
+            return super(EventLoop, self).add_signal_handler(sig, callback,
+                                                             *args)
+        old = self._glib_signals.get(sig)
+        if old is not None:
+            old.cancel()
+        self._glib_signals[sig] = handle
+
+    def remove_signal_handler(self, sig):
+        handle = self._glib_signals.pop(sig, None)
+        if handle is None:
+            return super(EventLoop, self).remove_signal_handler(sig)
+
+        handle.cancel()
+        self._source.remove_signal(sig)
+        if sig == signal.SIGINT:
+            signal.signal(sig, signal.default_int_handler)
+        return True
+
+
+class EventLoopPolicy(asyncio.DefaultEventLoopPolicy):
+    """Event loop policy creating glib.eventloop.EventLoop instances.
+
+    Loops created in the main thread run on the default main context,
+    loops created in other threads on a new context of their own.
+    """
+
+    def new_event_loop(self):
+        if threading.current_thread() is threading.main_thread():
+            return EventLoop()
+        return EventLoop(glib.MainContext())
@@ -33,6 +33,7 @@
 #include <glib.h>
 #include "pyglib.h"
 #include "pyglib-private.h"
+#include "pygeventloop.h"
 #include "pygiochannel.h"
 #include "pygmaincontext.h"
 #include "pygmainloop.h"
@@ -40,6 +41,7 @@
 #include "pygoptiongroup.h"
 #include "pygsource.h"
 #include "pygspawn.h"
+#include "pygtimerwheel.h"
 
 #define PYGLIB_MAJOR_VERSION PYGOBJECT_MAJOR_VERSION
 #define PYGLIB_MINOR_VERSION PYGOBJECT_MINOR_VERSION
@@ -229,11 +231,13 @@ iowatch_marshal(GIOChannel *source,
     PyGILState_STATE state;
     PyObject *tuple, *func, *firstargs, *args, *ret;
     gboolean res;
+    gint64 start;
 
     g_return_val_if_fail(user_data != NULL, FALSE);
 
     state = pyglib_gil_state_ensure();
 
+    start = _pyglib_dispatch_stats_begin();
     tuple = (PyObject *)user_data;
     func = PyTuple_GetItem(tuple, 0);
 
@@ -258,6 +262,7 @@ iowatch_marshal(GIOChannel *source,
 	res = PyObject_IsTrue(ret);
 	Py_DECREF(ret);
     }
+    _pyglib_dispatch_stats_end(start, func);
 
     pyglib_gil_state_release(state);
 
@@ -320,6 +325,9 @@ pyglib_source_remove(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "i:source_remove", &tag))
 	return NULL;
 
+    if (pyg_timer_wheel_remove_id(tag))
+	return PyBool_FromLong(TRUE);
+
     return PyBool_FromLong(g_source_remove(tag));
 }
 
@@ -335,8 +343,10 @@ child_watch_func(GPid pid, gint status, gpointer data)
     struct _PyGChildData *child_data = (struct _PyGChildData *) data;
     PyObject *retval;
     PyGILState_STATE gil;
+    gint64 start;
 
     gil = pyglib_gil_state_ensure();
+    start = _pyglib_dispatch_stats_begin();
     if (child_data->data)
         retval = PyObject_CallFunction(child_data->func, "iiO", pid, status,
                                        child_data->data);
@@ -347,6 +357,7 @@ child_watch_func(GPid pid, gint status, gpointer data)
 	Py_DECREF(retval);
     else
 	PyErr_Print();
+    _pyglib_dispatch_stats_end(start, child_data->func);
 
     pyglib_gil_state_release(gil);
 }
@@ -677,6 +688,47 @@ pyglib_get_system_data_dirs(PyObject *self)
     return tuple_of_strings_from_dirs(g_get_system_data_dirs());
 }
 
+static PyObject *
+pyglib_get_freelist_stats(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "reset", NULL };
+    PyObject *py_reset = Py_False;
+    int reset;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:get_freelist_stats",
+				     kwlist, &py_reset))
+	return NULL;
+
+    reset = PyObject_IsTrue(py_reset);
+    if (reset < 0)
+	return NULL;
+
+    return _pyglib_freelist_get_stats(reset);
+}
+
+static PyObject *
+pyglib_get_freelist_limit(PyObject *self)
+{
+    return PYGLIB_PyLong_FromLong(_pyglib_freelist_get_limit());
+}
+
+static PyObject *
+pyglib_set_freelist_limit(PyObject *self, PyObject *args)
+{
+    int limit;
+
+    if (!PyArg_ParseTuple(args, "i:set_freelist_limit", &limit))
+	return NULL;
+
+    if (limit < 0) {
+	PyErr_SetString(PyExc_ValueError, "limit must not be negative");
+	return NULL;
+    }
+
+    _pyglib_freelist_set_limit(limit);
+    Py_RETURN_NONE;
+}
+
 static PyMethodDef _glib_functions[] = {
     { "threads_init",
       (PyCFunction) pyglib_threads_init, METH_NOARGS,
@@ -726,7 +778,7 @@ static PyMethodDef _glib_functions[] = {
       "source_remove(source_id) -> True if removed\n"
       "Removes the event source specified by source id as returned by the\n"
       "glib.idle_add(), glib.timeout_add() or glib.io_add_watch()\n"
-      "functions." },
+      "functions, or a timer id returned by glib.TimerWheel.add()." },
     { "spawn_async",
       (PyCFunction)pyglib_spawn_async, METH_VARARGS|METH_KEYWORDS,
       "spawn_async(argv, envp=None, working_directory=None,\n"
@@ -782,6 +834,22 @@ static PyMethodDef _glib_functions[] = {
       (PyCFunction)pyglib_get_system_config_dirs, METH_NOARGS },
     { "get_system_data_dirs",
       (PyCFunction)pyglib_get_system_data_dirs, METH_NOARGS },
+    { "get_freelist_stats",
+      (PyCFunction)pyglib_get_freelist_stats, METH_VARARGS|METH_KEYWORDS,
+      "get_freelist_stats(reset=False) -> list of dicts\n"
+      "Returns, for every free list of gobject and gi wrapper instances,\n"
+      "its name, instance size and length, the allocations it was asked\n"
+      "for and the hits among them, the deallocated instances offered\n"
+      "to it and the ones it kept." },
+    { "get_freelist_limit",
+      (PyCFunction)pyglib_get_freelist_limit, METH_NOARGS,
+      "get_freelist_limit() -> int\n"
+      "Returns the number of instances each wrapper free list keeps." },
+    { "set_freelist_limit",
+      (PyCFunction)pyglib_set_freelist_limit, METH_VARARGS,
+      "set_freelist_limit(limit)\n"
+      "Sets the number of instances each wrapper free list keeps and\n"
+      "releases the ones over it; 0 disables the free lists." },
     { NULL, NULL, 0 }
 };
 
@@ -795,6 +863,9 @@ static struct _PyGLib_Functions pyglib_api = {
     pyg_main_context_new,
     pyg_option_context_new,
     pyg_option_group_new,
+    _pyglib_freelist_register,
+    _pyglib_freelist_unregister,
+    NULL,  /* gil_ensure_hook */
 };
 
 static void
@@ -966,6 +1037,8 @@ PYGLIB_MODULE_START(_glib, "glib._glib")
     pyglib_mainloop_register_types(d);
     pyglib_maincontext_register_types(d);
     pyglib_source_register_types(d);
+    pyglib_timer_wheel_register_types(d);
+    pyglib_event_loop_register_types(d);
     pyglib_spawn_register_types(d);
     pyglib_option_context_register_types(d);
     pyglib_option_group_register_types(d);
@@ -0,0 +1,804 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * pyglib - Python bindings for GLib toolkit.
+ * Copyright (C) 1998-2003  James Henstridge
+ *               2004-2008  Johan Dahlin
+ *
+ *   pygeventloop.c: GSource driving an asyncio event loop
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301
+ * USA
+ */
+
+/*
+ * A glib.EventLoopSource carries everything glib.eventloop.EventLoop
+ * schedules: the queue of ready callbacks, a binary heap of timers, the
+ * file descriptors watched for readers and writers and, where GLib
+ * supports it, Unix signals.  The objects it stores are asyncio handles;
+ * a dispatch runs every handle that was ready when it started, calling
+ * handle._run() unless handle._cancelled is set, so the main loop only
+ * crosses into Python for the callbacks themselves.
+ *
+ * prepare() and check() run without the GIL.  The ready queue and the
+ * timer heap are protected by a lock since call_soon_threadsafe() may
+ * fill them from another thread; watches and signals are only changed
+ * from the thread running the loop.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <Python.h>
+#include <pythread.h>
+#include "pyglib.h"
+#include "pyglib-private.h"
+#include "pygsource.h"
+#include "pygeventloop.h"
+
+#if defined(G_OS_UNIX) && GLIB_CHECK_VERSION(2, 30, 0)
+#include <signal.h>
+#include <glib-unix.h>
+#define PYG_EVENT_LOOP_SIGNALS 1
+#endif
+
+#define CHECK_DESTROYED(self, ret)			G_STMT_START {	\
+    if ((self)->source == NULL) {					\
+	PyErr_SetString(PyExc_RuntimeError, "source is destroyed");	\
+	return (ret);							\
+    }									\
+} G_STMT_END
+
+typedef struct {
+    gint64 when;		/* monotonic time, in microseconds */
+    guint64 seq;		/* keeps timers with equal deadlines FIFO */
+    PyObject *handle;
+} PyGEventTimer;
+
+typedef struct {
+    GPollFD pollfd;
+    PyObject *reader;
+    PyObject *writer;
+} PyGEventWatch;
+
+typedef struct {
+    GSource source;
+    GQueue ready;
+    GArray *timers;
+    guint64 timer_seq;
+    GHashTable *watches;	/* fd -> PyGEventWatch */
+    GHashTable *signals;	/* signum -> GSource */
+} PyGEventLoopSource;
+
+#ifdef PYG_EVENT_LOOP_SIGNALS
+typedef struct {
+    PyGEventLoopSource *loop;
+    PyObject *handle;
+} PyGEventSignal;
+#endif
+
+G_LOCK_DEFINE_STATIC(event_loop);
+
+static PyObject *run_str, *cancelled_str;
+
+#define TIMER_AT(loop, i) (&g_array_index((loop)->timers, PyGEventTimer, (i)))
+
+static gboolean
+timer_before(PyGEventTimer *a, PyGEventTimer *b)
+{
+    return a->when < b->when || (a->when == b->when && a->seq < b->seq);
+}
+
+static void
+timer_swap(PyGEventLoopSource *loop, guint i, guint j)
+{
+    PyGEventTimer tmp = *TIMER_AT(loop, i);
+
+    *TIMER_AT(loop, i) = *TIMER_AT(loop, j);
+    *TIMER_AT(loop, j) = tmp;
+}
+
+/* called with the lock held */
+static void
+timers_insert(PyGEventLoopSource *loop, PyGEventTimer *timer)
+{
+    guint i;
+
+    g_array_append_val(loop->timers, *timer);
+
+    for (i = loop->timers->len - 1; i > 0; i = (i - 1) / 2) {
+	if (!timer_before(TIMER_AT(loop, i), TIMER_AT(loop, (i - 1) / 2)))
+	    break;
+	timer_swap(loop, i, (i - 1) / 2);
+    }
+}
+
+/* called with the lock held */
+static void
+timers_push(PyGEventLoopSource *loop, gint64 when, PyObject *handle)
+{
+    PyGEventTimer timer;
+
+    timer.when = when;
+    timer.seq = loop->timer_seq++;
+    timer.handle = handle;
+    timers_insert(loop, &timer);
+}
+
+/* called with the lock held; returns the handle of the earliest timer */
+static PyObject *
+timers_pop(PyGEventLoopSource *loop)
+{
+    PyObject *handle = TIMER_AT(loop, 0)->handle;
+    guint i = 0, len;
+
+    len = loop->timers->len - 1;
+    *TIMER_AT(loop, 0) = *TIMER_AT(loop, len);
+    g_array_set_size(loop->timers, len);
+
+    for (;;) {
+	guint child = 2 * i + 1;
+
+	if (child >= len)
+	    break;
+	if (child + 1 < len
+	    && timer_before(TIMER_AT(loop, child + 1), TIMER_AT(loop, child)))
+	    child++;
+	if (!timer_before(TIMER_AT(loop, child), TIMER_AT(loop, i)))
+	    break;
+	timer_swap(loop, i, child);
+	i = child;
+    }
+
+    return handle;
+}
+
+/* Wakes the context up when called from a thread that is not running it,
+ * the loop would otherwise sleep through the new work. */
+static void
+event_loop_wakeup(PyGEventLoopSource *loop)
+{
+    GMainContext *context = g_source_get_context(&loop->source);
+
+    if (context && !g_main_context_is_owner(context))
+	g_main_context_wakeup(context);
+}
+
+/* must be called with the GIL held; steals the reference to @handle */
+static void
+event_loop_push_ready(PyGEventLoopSource *loop, PyObject *handle)
+{
+    G_LOCK(event_loop);
+    g_queue_push_tail(&loop->ready, handle);
+    G_UNLOCK(event_loop);
+}
+
+static gboolean
+pyg_event_loop_prepare(GSource *source, gint *timeout)
+{
+    PyGEventLoopSource *loop = (PyGEventLoopSource *)source;
+    gboolean ready = FALSE;
+
+    G_LOCK(event_loop);
+    if (!g_queue_is_empty(&loop->ready)) {
+	ready = TRUE;
+	*timeout = 0;
+    } else if (loop->timers->len > 0) {
+	gint64 remaining;
+
+	remaining = TIMER_AT(loop, 0)->when - _pyglib_get_monotonic_time();
+	if (remaining <= 0) {
+	    ready = TRUE;
+	    *timeout = 0;
+	} else
+	    *timeout = (gint)MIN((remaining + 999) / 1000, G_MAXINT);
+    } else
+	*timeout = -1;
+    G_UNLOCK(event_loop);
+
+    return ready;
+}
+
+static gboolean
+pyg_event_loop_check(GSource *source)
+{
+    PyGEventLoopSource *loop = (PyGEventLoopSource *)source;
+    GHashTableIter iter;
+    gpointer value;
+    gboolean ready;
+
+    G_LOCK(event_loop);
+    ready = !g_queue_is_empty(&loop->ready)
+	|| (loop->timers->len > 0
+	    && TIMER_AT(loop, 0)->when <= _pyglib_get_monotonic_time());
+    G_UNLOCK(event_loop);
+
+    if (ready)
+	return TRUE;
+
+    g_hash_table_iter_init(&iter, loop->watches);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+	if (((PyGEventWatch *)value)->pollfd.revents)
+	    return TRUE;
+
+    return FALSE;
+}
+
+/* Queues the handles of the watches whose fds are ready, the way a
+ * selector reports them: errors and hangups wake both directions. */
+static void
+event_loop_queue_watches(PyGEventLoopSource *loop)
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, loop->watches);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+	PyGEventWatch *watch = value;
+	gushort revents = watch->pollfd.revents;
+
+	if (revents == 0)
+	    continue;
+	watch->pollfd.revents = 0;
+
+	if (watch->reader && (revents & (G_IO_IN | G_IO_HUP | G_IO_ERR))) {
+	    Py_INCREF(watch->reader);
+	    event_loop_push_ready(loop, watch->reader);
+	}
+	if (watch->writer && (revents & (G_IO_OUT | G_IO_HUP | G_IO_ERR))) {
+	    Py_INCREF(watch->writer);
+	    event_loop_push_ready(loop, watch->writer);
+	}
+    }
+}
+
+static void
+event_loop_run_handle(PyObject *handle)
+{
+    PyObject *cancelled, *ret;
+    int skip;
+
+    cancelled = PyObject_GetAttr(handle, cancelled_str);
+    if (cancelled == NULL) {
+	PyErr_Print();
+	return;
+    }
+    skip = PyObject_IsTrue(cancelled);
+    Py_DECREF(cancelled);
+    if (skip)
+	return;
+
+    ret = PyObject_CallMethodObjArgs(handle, run_str, NULL);
+    if (ret == NULL)
+	PyErr_Print();
+    Py_XDECREF(ret);
+}
+
+static gboolean
+pyg_event_loop_dispatch(GSource *source, GSourceFunc callback,
+			gpointer user_data)
+{
+    PyGEventLoopSource *loop = (PyGEventLoopSource *)source;
+    PyGILState_STATE state;
+    gint64 now;
+    guint n_ready;
+
+    state = pyglib_gil_state_ensure();
+
+    event_loop_queue_watches(loop);
+
+    now = _pyglib_get_monotonic_time();
+    G_LOCK(event_loop);
+    while (loop->timers->len > 0 && TIMER_AT(loop, 0)->when <= now)
+	g_queue_push_tail(&loop->ready, timers_pop(loop));
+
+    /* callbacks scheduled by these handles wait for the next dispatch,
+     * so a callback rescheduling itself cannot starve the main loop */
+    n_ready = g_queue_get_length(&loop->ready);
+    while (n_ready-- > 0) {
+	PyObject *handle = g_queue_pop_head(&loop->ready);
+
+	G_UNLOCK(event_loop);
+	event_loop_run_handle(handle);
+	Py_DECREF(handle);
+	G_LOCK(event_loop);
+    }
+    G_UNLOCK(event_loop);
+
+    pyglib_gil_state_release(state);
+
+    return TRUE;
+}
+
+static void
+event_loop_watch_free(PyGEventWatch *watch)
+{
+    Py_XDECREF(watch->reader);
+    Py_XDECREF(watch->writer);
+    g_slice_free(PyGEventWatch, watch);
+}
+
+static void
+pyg_event_loop_finalize(GSource *source)
+{
+    PyGEventLoopSource *loop = (PyGEventLoopSource *)source;
+    PyGILState_STATE state;
+    PyObject *handle;
+    guint i;
+
+    state = pyglib_gil_state_ensure();
+
+    while ((handle = g_queue_pop_head(&loop->ready)) != NULL)
+	Py_DECREF(handle);
+
+    for (i = 0; i < loop->timers->len; i++)
+	Py_DECREF(TIMER_AT(loop, i)->handle);
+    g_array_free(loop->timers, TRUE);
+
+    g_hash_table_destroy(loop->watches);
+    g_hash_table_destroy(loop->signals);
+
+    pyglib_gil_state_release(state);
+}
+
+static GSourceFuncs pyg_event_loop_funcs =
+{
+    pyg_event_loop_prepare,
+    pyg_event_loop_check,
+    pyg_event_loop_dispatch,
+    pyg_event_loop_finalize
+};
+
+#ifdef PYG_EVENT_LOOP_SIGNALS
+static gboolean
+event_loop_signal_cb(gpointer user_data)
+{
+    PyGEventSignal *signal = user_data;
+    PyGILState_STATE state;
+
+    state = pyglib_gil_state_ensure();
+    Py_INCREF(signal->handle);
+    event_loop_push_ready(signal->loop, signal->handle);
+    pyglib_gil_state_release(state);
+
+    return TRUE;
+}
+
+static void
+event_loop_signal_free(PyGEventSignal *signal)
+{
+    PyGILState_STATE state;
+
+    state = pyglib_gil_state_ensure();
+    Py_DECREF(signal->handle);
+    pyglib_gil_state_release(state);
+
+    g_slice_free(PyGEventSignal, signal);
+}
+
+static void
+event_loop_signal_source_free(GSource *source)
+{
+    g_source_destroy(source);
+    g_source_unref(source);
+}
+#endif
+
+/* glib.EventLoopSource */
+
+PYGLIB_DEFINE_TYPE("glib.EventLoopSource", PyGEventLoopSource_Type, PyGSource)
+
+static PyObject *
+pyg_event_loop_source_repr(PyGSource *self)
+{
+    const char *desc;
+    guint ready = 0, timers = 0;
+
+    if (self->source) {
+	PyGEventLoopSource *loop = (PyGEventLoopSource *)self->source;
+
+	desc = g_source_get_context(self->source) ? "attached" : "unattached";
+	G_LOCK(event_loop);
+	ready = g_queue_get_length(&loop->ready);
+	timers = loop->timers->len;
+	G_UNLOCK(event_loop);
+    } else {
+	desc = "destroyed";
+    }
+
+    return PYGLIB_PyUnicode_FromFormat("<%s glib event loop source with "
+				       "%u ready and %u timers at 0x%lx>",
+				       desc, ready, timers, (long)self);
+}
+
+static int
+pyg_event_loop_source_init(PyGSource *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "priority", NULL };
+    gint priority = G_PRIORITY_DEFAULT;
+    PyGEventLoopSource *loop;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "|i:glib.EventLoopSource.__init__",
+				     kwlist, &priority))
+	return -1;
+
+    self->source = g_source_new(&pyg_event_loop_funcs,
+				sizeof(PyGEventLoopSource));
+
+    loop = (PyGEventLoopSource *)self->source;
+    g_queue_init(&loop->ready);
+    loop->timers = g_array_new(FALSE, FALSE, sizeof(PyGEventTimer));
+    loop->watches = g_hash_table_new_full(NULL, NULL, NULL,
+					  (GDestroyNotify)event_loop_watch_free);
+#ifdef PYG_EVENT_LOOP_SIGNALS
+    loop->signals = g_hash_table_new_full(NULL, NULL, NULL,
+					  (GDestroyNotify)event_loop_signal_source_free);
+#else
+    loop->signals = g_hash_table_new(NULL, NULL);
+#endif
+
+    if (priority != G_PRIORITY_DEFAULT)
+	g_source_set_priority(self->source, priority);
+
+    self->inst_dict = NULL;
+    self->weakreflist = NULL;
+
+    self->python_source = FALSE;
+
+    return 0;
+}
+
+static PyObject *
+pyg_event_loop_source_call_soon(PyGSource *self, PyObject *handle)
+{
+    CHECK_DESTROYED(self, NULL);
+
+    Py_INCREF(handle);
+    event_loop_push_ready((PyGEventLoopSource *)self->source, handle);
+    event_loop_wakeup((PyGEventLoopSource *)self->source);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_event_loop_source_call_at(PyGSource *self, PyObject *args)
+{
+    PyGEventLoopSource *loop;
+    PyObject *handle;
+    double when;
+
+    if (!PyArg_ParseTuple(args, "dO:call_at", &when, &handle))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+    loop = (PyGEventLoopSource *)self->source;
+    Py_INCREF(handle);
+    G_LOCK(event_loop);
+    timers_push(loop, (gint64)(when * G_USEC_PER_SEC), handle);
+    G_UNLOCK(event_loop);
+    event_loop_wakeup(loop);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Sets the reader or writer of @fd, returning the previous one. */
+static PyObject *
+event_loop_set_watch(PyGSource *self, PyObject *args, const char *format,
+		     gboolean writer)
+{
+    PyGEventLoopSource *loop;
+    PyGEventWatch *watch;
+    PyObject *handle = NULL, **slot, *old;
+    int fd;
+
+    if (!PyArg_ParseTuple(args, format, &fd, &handle))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+    if (handle == Py_None)
+	handle = NULL;
+
+    loop = (PyGEventLoopSource *)self->source;
+    watch = g_hash_table_lookup(loop->watches, GINT_TO_POINTER(fd));
+    if (watch == NULL) {
+	if (handle == NULL) {
+	    Py_INCREF(Py_None);
+	    return Py_None;
+	}
+	watch = g_slice_new0(PyGEventWatch);
+	watch->pollfd.fd = fd;
+	g_hash_table_insert(loop->watches, GINT_TO_POINTER(fd), watch);
+	g_source_add_poll(self->source, &watch->pollfd);
+    }
+
+    slot = writer ? &watch->writer : &watch->reader;
+    old = *slot;
+    Py_XINCREF(handle);
+    *slot = handle;
+
+    watch->pollfd.events = 0;
+    if (watch->reader)
+	watch->pollfd.events |= G_IO_IN | G_IO_HUP | G_IO_ERR;
+    if (watch->writer)
+	watch->pollfd.events |= G_IO_OUT | G_IO_ERR;
+
+    if (watch->pollfd.events == 0) {
+	g_source_remove_poll(self->source, &watch->pollfd);
+	g_hash_table_remove(loop->watches, GINT_TO_POINTER(fd));
+    }
+
+    if (old == NULL) {
+	Py_INCREF(Py_None);
+	return Py_None;
+    }
+    return old;
+}
+
+static PyObject *
+pyg_event_loop_source_add_reader(PyGSource *self, PyObject *args)
+{
+    return event_loop_set_watch(self, args, "iO:add_reader", FALSE);
+}
+
+static PyObject *
+pyg_event_loop_source_remove_reader(PyGSource *self, PyObject *args)
+{
+    return event_loop_set_watch(self, args, "i:remove_reader", FALSE);
+}
+
+static PyObject *
+pyg_event_loop_source_add_writer(PyGSource *self, PyObject *args)
+{
+    return event_loop_set_watch(self, args, "iO:add_writer", TRUE);
+}
+
+static PyObject *
+pyg_event_loop_source_remove_writer(PyGSource *self, PyObject *args)
+{
+    return event_loop_set_watch(self, args, "i:remove_writer", TRUE);
+}
+
+static PyObject *
+pyg_event_loop_source_add_signal(PyGSource *self, PyObject *args)
+{
+    PyObject *handle;
+    int signum;
+
+    if (!PyArg_ParseTuple(args, "iO:add_signal", &signum, &handle))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+#ifdef PYG_EVENT_LOOP_SIGNALS
+    {
+	PyGEventLoopSource *loop = (PyGEventLoopSource *)self->source;
+	GMainContext *context = g_source_get_context(self->source);
+	PyGEventSignal *signal;
+	GSource *source;
+
+	if (context == NULL) {
+	    PyErr_SetString(PyExc_RuntimeError, "source is not attached");
+	    return NULL;
+	}
+
+	switch (signum) {
+	case SIGHUP:
+	case SIGINT:
+	case SIGTERM:
+	case SIGUSR1:
+	case SIGUSR2:
+#if GLIB_CHECK_VERSION(2, 54, 0)
+	case SIGWINCH:
+#endif
+	    break;
+	default:
+	    PyErr_Format(PyExc_ValueError,
+			 "signal %d cannot be watched by GLib", signum);
+	    return NULL;
+	}
+
+	signal = g_slice_new(PyGEventSignal);
+	signal->loop = loop;
+	signal->handle = handle;
+	Py_INCREF(handle);
+
+	source = g_unix_signal_source_new(signum);
+	g_source_set_callback(source, event_loop_signal_cb, signal,
+			      (GDestroyNotify)event_loop_signal_free);
+	g_source_set_priority(source, g_source_get_priority(self->source));
+	g_source_attach(source, context);
+	g_hash_table_replace(loop->signals, GINT_TO_POINTER(signum), source);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+#else
+    PyErr_Format(PyExc_ValueError,
+		 "signal %d cannot be watched by GLib", signum);
+    return NULL;
+#endif
+}
+
+static PyObject *
+pyg_event_loop_source_remove_signal(PyGSource *self, PyObject *args)
+{
+    PyGEventLoopSource *loop;
+    int signum;
+
+    if (!PyArg_ParseTuple(args, "i:remove_signal", &signum))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+    loop = (PyGEventLoopSource *)self->source;
+    return PyBool_FromLong(g_hash_table_remove(loop->signals,
+					       GINT_TO_POINTER(signum)));
+}
+
+static PyObject *
+pyg_event_loop_source_purge_cancelled(PyGSource *self)
+{
+    PyGEventLoopSource *loop;
+    GArray *timers;
+    guint i, purged = 0;
+
+    CHECK_DESTROYED(self, NULL);
+
+    /* take the heap over, the handles are inspected without the lock */
+    loop = (PyGEventLoopSource *)self->source;
+    G_LOCK(event_loop);
+    timers = loop->timers;
+    loop->timers = g_array_sized_new(FALSE, FALSE, sizeof(PyGEventTimer),
+				     timers->len);
+    G_UNLOCK(event_loop);
+
+    for (i = 0; i < timers->len; i++) {
+	PyGEventTimer *timer = &g_array_index(timers, PyGEventTimer, i);
+	PyObject *cancelled;
+	int skip = 0;
+
+	cancelled = PyObject_GetAttr(timer->handle, cancelled_str);
+	if (cancelled == NULL)
+	    PyErr_Clear();
+	else {
+	    skip = PyObject_IsTrue(cancelled);
+	    Py_DECREF(cancelled);
+	    if (skip < 0) {
+		PyErr_Clear();
+		skip = 0;
+	    }
+	}
+
+	if (skip) {
+	    Py_CLEAR(timer->handle);
+	    purged++;
+	}
+    }
+
+    G_LOCK(event_loop);
+    for (i = 0; i < timers->len; i++) {
+	PyGEventTimer *timer = &g_array_index(timers, PyGEventTimer, i);
+
+	if (timer->handle)
+	    timers_insert(loop, timer);
+    }
+    G_UNLOCK(event_loop);
+
+    g_array_free(timers, TRUE);
+
+    return PYGLIB_PyLong_FromLong(purged);
+}
+
+static PyObject *
+pyg_event_loop_source_clear(PyGSource *self)
+{
+    PyGEventLoopSource *loop;
+    GQueue ready;
+    GArray *timers;
+    GHashTableIter iter;
+    PyObject *handle;
+    gpointer value;
+    guint i;
+
+    CHECK_DESTROYED(self, NULL);
+
+    /* glib.Source.destroy() keeps the GSource alive, so finalize would
+     * never get to release what the loop still holds */
+    loop = (PyGEventLoopSource *)self->source;
+    G_LOCK(event_loop);
+    ready = loop->ready;
+    g_queue_init(&loop->ready);
+    timers = loop->timers;
+    loop->timers = g_array_new(FALSE, FALSE, sizeof(PyGEventTimer));
+    G_UNLOCK(event_loop);
+
+    while ((handle = g_queue_pop_head(&ready)) != NULL)
+	Py_DECREF(handle);
+
+    for (i = 0; i < timers->len; i++)
+	Py_DECREF(g_array_index(timers, PyGEventTimer, i).handle);
+    g_array_free(timers, TRUE);
+
+    g_hash_table_iter_init(&iter, loop->watches);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+	g_source_remove_poll(self->source, &((PyGEventWatch *)value)->pollfd);
+    g_hash_table_remove_all(loop->watches);
+
+    g_hash_table_remove_all(loop->signals);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_event_loop_source_time(PyGSource *self)
+{
+    return PyFloat_FromDouble((double)_pyglib_get_monotonic_time() /
+			      G_USEC_PER_SEC);
+}
+
+static Py_ssize_t
+pyg_event_loop_source_length(PyGSource *self)
+{
+    PyGEventLoopSource *loop;
+    Py_ssize_t length;
+
+    CHECK_DESTROYED(self, -1);
+
+    loop = (PyGEventLoopSource *)self->source;
+    G_LOCK(event_loop);
+    length = g_queue_get_length(&loop->ready) + loop->timers->len;
+    G_UNLOCK(event_loop);
+
+    return length;
+}
+
+static PyMethodDef pyg_event_loop_source_methods[] = {
+    { "call_soon", (PyCFunction)pyg_event_loop_source_call_soon, METH_O },
+    { "call_at", (PyCFunction)pyg_event_loop_source_call_at, METH_VARARGS },
+    { "add_reader", (PyCFunction)pyg_event_loop_source_add_reader, METH_VARARGS },
+    { "remove_reader", (PyCFunction)pyg_event_loop_source_remove_reader, METH_VARARGS },
+    { "add_writer", (PyCFunction)pyg_event_loop_source_add_writer, METH_VARARGS },
+    { "remove_writer", (PyCFunction)pyg_event_loop_source_remove_writer, METH_VARARGS },
+    { "add_signal", (PyCFunction)pyg_event_loop_source_add_signal, METH_VARARGS },
+    { "remove_signal", (PyCFunction)pyg_event_loop_source_remove_signal, METH_VARARGS },
+    { "purge_cancelled", (PyCFunction)pyg_event_loop_source_purge_cancelled, METH_NOARGS },
+    { "clear", (PyCFunction)pyg_event_loop_source_clear, METH_NOARGS },
+    { "time", (PyCFunction)pyg_event_loop_source_time, METH_NOARGS },
+    { NULL, NULL, 0 }
+};
+
+static PySequenceMethods pyg_event_loop_source_as_sequence = {
+    (lenfunc)pyg_event_loop_source_length,
+};
+
+void
+pyglib_event_loop_register_types(PyObject *d)
+{
+    run_str = PYGLIB_PyUnicode_FromString("_run");
+    cancelled_str = PYGLIB_PyUnicode_FromString("_cancelled");
+
+    PyGEventLoopSource_Type.tp_repr = (reprfunc)pyg_event_loop_source_repr;
+    PyGEventLoopSource_Type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+    PyGEventLoopSource_Type.tp_base = (PyTypeObject *)&PyGSource_Type;
+    PyGEventLoopSource_Type.tp_init = (initproc)pyg_event_loop_source_init;
+    PyGEventLoopSource_Type.tp_methods = pyg_event_loop_source_methods;
+    PyGEventLoopSource_Type.tp_as_sequence = &pyg_event_loop_source_as_sequence;
+    PYGLIB_REGISTER_TYPE(d, PyGEventLoopSource_Type, "EventLoopSource");
+}
@@ -12,6 +12,11 @@
 #include "pyglib-private.h"
 #include "pygsource.h"
 
+#ifdef G_OS_UNIX
+#include <errno.h>
+#include <sys/uio.h>
+#endif
+
 typedef struct {
     PyObject_HEAD
     GIOChannel *channel;
@@ -256,6 +261,33 @@ py_io_channel_read_chars(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
     return NULL;
 }
 
+static PyObject*
+py_io_channel_readinto(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "buffer", NULL };
+    Py_buffer view;
+    gsize total_read = 0;
+    GError* error = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "w*:glib.IOChannel.readinto",
+                                     kwlist, &view))
+        return NULL;
+
+    /* read straight into the caller's memory; like a single read() this
+     * returns a short count rather than waiting for the buffer to fill */
+    pyglib_unblock_threads();
+    g_io_channel_read_chars(self->channel, view.buf, view.len,
+                            &total_read, &error);
+    pyglib_block_threads();
+
+    PyBuffer_Release(&view);
+
+    if (pyglib_error_check(&error))
+        return NULL;
+
+    return PYGLIB_PyLong_FromLong(total_read);
+}
+
 static PyObject*
 py_io_channel_write_chars(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
 {
@@ -279,49 +311,186 @@ py_io_channel_write_chars(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
     return PYGLIB_PyLong_FromLong(count);
 }
 
+/* Writes @n_bufs buffers in order.  Unbuffered channels go straight to
+ * writev() on the file descriptor, everything else through the channel's
+ * write buffer.  Called without the GIL; stops at the first short write
+ * and returns the number of bytes written. */
+static gsize
+py_io_channel_write_buffers(GIOChannel *channel, const gchar **bufs,
+			    const gsize *lens, gsize n_bufs, GError **error)
+{
+    gsize total = 0, i;
+
+#ifdef G_OS_UNIX
+    if (!g_io_channel_get_buffered(channel)) {
+	int fd = g_io_channel_unix_get_fd(channel);
+	struct iovec iov[64];
+	gsize first = 0, offset = 0;
+
+	/* a short write is retried with the remainder; a non-blocking fd
+	 * that is full then fails with EAGAIN and we stop there */
+	while (first < n_bufs) {
+	    gsize n_iov = 0, done;
+	    ssize_t written;
+
+	    for (i = first; i < n_bufs && n_iov < G_N_ELEMENTS(iov); i++) {
+		gsize skip = i == first ? offset : 0;
+
+		iov[n_iov].iov_base = (gchar *)bufs[i] + skip;
+		iov[n_iov].iov_len = lens[i] - skip;
+		n_iov++;
+	    }
+
+	    written = writev(fd, iov, n_iov);
+	    if (written < 0) {
+		if (errno == EINTR)
+		    continue;
+		if (errno != EAGAIN)
+		    g_set_error_literal(error, G_IO_CHANNEL_ERROR,
+					g_io_channel_error_from_errno(errno),
+					g_strerror(errno));
+		break;
+	    }
+	    total += written;
+
+	    /* skip over what was written, possibly ending mid-buffer */
+	    done = written;
+	    while (first < n_bufs && done >= lens[first] - offset) {
+		done -= lens[first] - offset;
+		offset = 0;
+		first++;
+	    }
+	    offset += done;
+	}
+
+	return total;
+    }
+#endif
+
+    for (i = 0; i < n_bufs; i++) {
+	gsize count = 0;
+	GIOStatus status;
+
+	status = g_io_channel_write_chars(channel, bufs[i], lens[i],
+					  &count, error);
+	total += count;
+	if (status != G_IO_STATUS_NORMAL || count < lens[i])
+	    break;
+    }
+
+    return total;
+}
+
+static PyObject*
+py_io_channel_writev(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "buffers", NULL };
+    PyObject *py_buffers, *seq;
+    Py_buffer *views;
+    const gchar **bufs;
+    gsize *lens, count;
+    Py_ssize_t n_bufs, i, n_views = 0;
+    GError *error = NULL;
+    PyObject *ret = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O:glib.IOChannel.writev",
+				     kwlist, &py_buffers))
+        return NULL;
+
+    seq = PySequence_Fast(py_buffers, "buffers must be a sequence");
+    if (seq == NULL)
+	return NULL;
+
+    n_bufs = PySequence_Fast_GET_SIZE(seq);
+    views = g_new0(Py_buffer, n_bufs);
+    bufs = g_new(const gchar *, n_bufs);
+    lens = g_new(gsize, n_bufs);
+
+    for (i = 0; i < n_bufs; i++) {
+	PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+
+	if (PyObject_GetBuffer(item, &views[i], PyBUF_SIMPLE) == -1)
+	    goto out;
+	n_views++;
+	bufs[i] = views[i].buf;
+	lens[i] = views[i].len;
+    }
+
+    pyglib_unblock_threads();
+    count = py_io_channel_write_buffers(self->channel, bufs, lens, n_bufs,
+					&error);
+    pyglib_block_threads();
+    if (pyglib_error_check(&error))
+	goto out;
+
+    ret = PYGLIB_PyLong_FromLong(count);
+
+out:
+    for (i = 0; i < n_views; i++)
+	PyBuffer_Release(&views[i]);
+    g_free(views);
+    g_free(bufs);
+    g_free(lens);
+    Py_DECREF(seq);
+    return ret;
+}
+
 static PyObject*
 py_io_channel_write_lines(PyGIOChannel* self, PyObject *args, PyObject *kwargs)
 {
     static char *kwlist[] = { "lines", NULL };
     char *buf;
-    Py_ssize_t buf_len;
-    gsize count;
+    Py_ssize_t buf_len, n_lines, i;
+    const gchar **bufs;
+    gsize *lens;
     GError* error = NULL;
-    GIOStatus status;
-    PyObject *iter, *value, *pylines;
+    PyObject *lines, *pylines;
 
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O:glib.IOChannel.writelines",
                                      kwlist, &pylines))
         return NULL;
 
-    iter = PyObject_GetIter(pylines);
-    
-    while (1) {
-        value = PyIter_Next(iter);
-        if (PyErr_ExceptionMatches(PyExc_StopIteration)) {
-            PyErr_Clear();
-            goto normal_exit;
-        }
+    /* the list keeps the strings, and so the pointers into them, alive
+     * while the lines are written without the GIL */
+    lines = PySequence_List(pylines);
+    if (lines == NULL)
+        return NULL;
+
+    n_lines = PyList_GET_SIZE(lines);
+    bufs = g_new(const gchar *, n_lines);
+    lens = g_new(gsize, n_lines);
+
+    for (i = 0; i < n_lines; i++) {
+        PyObject *value = PyList_GET_ITEM(lines, i);
+
         if (!PYGLIB_PyUnicode_Check(value)) {
             PyErr_SetString(PyExc_TypeError, "glib.IOChannel.writelines must"
                             " be sequence/iterator of strings");
-            Py_DECREF(iter);
-            return NULL;
-        }
-        PYGLIB_PyUnicode_AsStringAndSize(value, &buf, &buf_len);
-        pyglib_unblock_threads();
-        status = g_io_channel_write_chars(self->channel, buf, buf_len, &count, &error);
-        pyglib_unblock_threads();
-        Py_DECREF(value);
-        if (pyglib_error_check(&error)) {
-            Py_DECREF(iter);
-            return NULL;
+            goto failure;
         }
+        if (PYGLIB_PyUnicode_AsStringAndSize(value, &buf, &buf_len) == -1)
+            goto failure;
+        bufs[i] = buf;
+        lens[i] = buf_len;
     }
-normal_exit:
-    Py_DECREF(iter);
+
+    pyglib_unblock_threads();
+    py_io_channel_write_buffers(self->channel, bufs, lens, n_lines, &error);
+    pyglib_block_threads();
+    if (pyglib_error_check(&error))
+        goto failure;
+
+    g_free(bufs);
+    g_free(lens);
+    Py_DECREF(lines);
     Py_INCREF(Py_None);
     return Py_None;
+
+failure:
+    g_free(bufs);
+    g_free(lens);
+    Py_DECREF(lines);
+    return NULL;
 }
 
 static PyObject*
@@ -421,6 +590,7 @@ pyg_iowatch_marshal(GIOChannel *source,
     gboolean res;
     PyGIOWatchData *data = (PyGIOWatchData *) user_data;
     PyGILState_STATE state;
+    gint64 start;
 
     g_return_val_if_fail(user_data != NULL, FALSE);
     g_return_val_if_fail(((PyGIOChannel *) data->iochannel)->channel == source,
@@ -428,6 +598,7 @@ pyg_iowatch_marshal(GIOChannel *source,
 
     state = pyglib_gil_state_ensure();
 
+    start = _pyglib_dispatch_stats_begin();
     if (data->user_data)
         ret = PyObject_CallFunction(data->callback, "OiO", data->iochannel,
                                     condition, data->user_data);
@@ -442,6 +613,7 @@ pyg_iowatch_marshal(GIOChannel *source,
 	res = PyObject_IsTrue(ret);
 	Py_DECREF(ret);
     }
+    _pyglib_dispatch_stats_end(start, data->callback);
     pyglib_gil_state_release(state);
 
     return res;
@@ -484,6 +656,206 @@ py_io_channel_add_watch(PyObject *self, PyObject *args, PyObject *kwargs)
     return PyLong_FromUnsignedLong(handler_id);
 }
 
+#define LINE_WATCH_CHUNK (64 * 1024)
+
+typedef struct {
+    PyObject *callback;
+    PyObject *iochannel;
+    PyObject *user_data;
+    GString *pending;       /* input not yet delivered as lines */
+    gsize max_lines;
+    gsize max_line_length;
+} PyGLineWatchData;
+
+static void
+pyg_line_watch_data_free(PyGLineWatchData *data)
+{
+    PyGILState_STATE state;
+
+    state = pyglib_gil_state_ensure();
+    Py_DECREF(data->callback);
+    Py_XDECREF(data->user_data);
+    Py_DECREF(data->iochannel);
+    pyglib_gil_state_release(state);
+
+    g_string_free(data->pending, TRUE);
+    g_slice_free(PyGLineWatchData, data);
+}
+
+/* Cuts up to max_lines lines off the front of the pending input.  Lines
+ * keep their '\n'; a line longer than max_line_length is delivered in
+ * pieces of that size, and at end of file the trailing partial line is
+ * delivered too. */
+static PyObject *
+pyg_line_watch_take_lines(PyGLineWatchData *data, gboolean eof)
+{
+    PyObject *lines;
+    gsize start = 0;
+
+    lines = PyList_New(0);
+    if (lines == NULL)
+	return NULL;
+
+    while (start < data->pending->len
+	   && (data->max_lines == 0
+	       || (gsize)PyList_GET_SIZE(lines) < data->max_lines)) {
+	const gchar *line = data->pending->str + start;
+	gsize avail = data->pending->len - start, len;
+	const gchar *nl;
+	PyObject *py_line;
+
+	nl = memchr(line, '\n', MIN(avail, data->max_line_length));
+	if (nl != NULL)
+	    len = nl - line + 1;
+	else if (avail >= data->max_line_length)
+	    len = data->max_line_length;
+	else if (eof)
+	    len = avail;
+	else
+	    break;
+
+	py_line = PYGLIB_PyBytes_FromStringAndSize(line, len);
+	if (py_line == NULL || PyList_Append(lines, py_line) == -1) {
+	    Py_XDECREF(py_line);
+	    Py_DECREF(lines);
+	    return NULL;
+	}
+	Py_DECREF(py_line);
+	start += len;
+    }
+
+    g_string_erase(data->pending, 0, start);
+    return lines;
+}
+
+static gboolean
+pyg_line_watch_marshal(GIOChannel *source,
+		       GIOCondition condition,
+		       gpointer user_data)
+{
+    PyGLineWatchData *data = (PyGLineWatchData *) user_data;
+    PyObject *lines, *ret;
+    PyGILState_STATE state;
+    GError *error = NULL;
+    GIOStatus status = G_IO_STATUS_NORMAL;
+    gboolean eof, res = TRUE;
+    gsize old_len, got = 0;
+
+    g_return_val_if_fail(user_data != NULL, FALSE);
+    g_return_val_if_fail(((PyGIOChannel *) data->iochannel)->channel == source,
+			 FALSE);
+
+    /* the channel is unbuffered, so this is a single read() that will
+     * not block; reading and framing happen without the GIL */
+    old_len = data->pending->len;
+    g_string_set_size(data->pending, old_len + LINE_WATCH_CHUNK);
+    if (condition & (G_IO_IN | G_IO_HUP | G_IO_ERR))
+	status = g_io_channel_read_chars(source, data->pending->str + old_len,
+					 LINE_WATCH_CHUNK, &got, &error);
+    g_string_set_size(data->pending, old_len + got);
+
+    eof = status == G_IO_STATUS_EOF || status == G_IO_STATUS_ERROR
+	|| (got == 0 && (condition & (G_IO_HUP | G_IO_ERR)));
+
+    state = pyglib_gil_state_ensure();
+
+    if (pyglib_error_check(&error)) {
+	PyErr_Print();
+	eof = TRUE;
+    }
+
+    /* one call per batch of complete lines; at end of file a final call
+     * with an empty list tells the callback no more lines will come */
+    while (res) {
+	lines = pyg_line_watch_take_lines(data, eof);
+	if (lines == NULL) {
+	    PyErr_Print();
+	    res = FALSE;
+	    break;
+	}
+	if (PyList_GET_SIZE(lines) == 0 && !eof) {
+	    Py_DECREF(lines);
+	    break;
+	}
+
+	if (data->user_data)
+	    ret = PyObject_CallFunction(data->callback, "OOO", data->iochannel,
+					lines, data->user_data);
+	else
+	    ret = PyObject_CallFunction(data->callback, "OO", data->iochannel,
+					lines);
+
+	if (!ret) {
+	    PyErr_Print();
+	    res = FALSE;
+	} else {
+	    res = PyObject_IsTrue(ret);
+	    Py_DECREF(ret);
+	}
+
+	if (PyList_GET_SIZE(lines) == 0) {
+	    Py_DECREF(lines);
+	    res = FALSE;
+	    break;
+	}
+	Py_DECREF(lines);
+    }
+
+    pyglib_gil_state_release(state);
+
+    return res;
+}
+
+static PyObject *
+py_io_channel_add_line_watch(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "callback", "user_data", "priority",
+			      "max_lines", "max_line_length", NULL };
+    PyObject *callback, *user_data = NULL;
+    int priority = G_PRIORITY_DEFAULT;
+    unsigned int max_lines = 1024, max_line_length = 64 * 1024;
+    GIOChannel *iochannel;
+    guint handler_id;
+    PyGLineWatchData *data;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "O|OiII:glib.IOChannel.add_line_watch",
+				     kwlist, &callback, &user_data, &priority,
+				     &max_lines, &max_line_length))
+	return NULL;
+
+    iochannel = ((PyGIOChannel *) self)->channel;
+
+    if (!PyCallable_Check(callback)) {
+	PyErr_SetString(PyExc_TypeError, "first argument must be callable");
+	return NULL;
+    }
+    if (max_line_length == 0) {
+	PyErr_SetString(PyExc_ValueError, "max_line_length must be positive");
+	return NULL;
+    }
+    if (g_io_channel_get_buffered(iochannel)) {
+	PyErr_SetString(PyExc_ValueError,
+			"add_line_watch needs an unbuffered channel, call "
+			"set_encoding(None) and set_buffered(False) first");
+	return NULL;
+    }
+
+    data = g_slice_new(PyGLineWatchData);
+    data->callback = callback; Py_INCREF(callback);
+    data->user_data = user_data; Py_XINCREF(user_data);
+    data->iochannel = self; Py_INCREF(self);
+    data->pending = g_string_sized_new(LINE_WATCH_CHUNK);
+    data->max_lines = max_lines;
+    data->max_line_length = max_line_length;
+
+    handler_id = g_io_add_watch_full(iochannel, priority,
+				     G_IO_IN | G_IO_HUP | G_IO_ERR,
+				     pyg_line_watch_marshal, data,
+				     (GDestroyNotify) pyg_line_watch_data_free);
+    return PyLong_FromUnsignedLong(handler_id);
+}
+
 
 #ifdef G_OS_WIN32
 
@@ -676,16 +1048,19 @@ static PyMethodDef py_io_channel_methods[] = {
     { "set_buffer_size", (PyCFunction)py_io_channel_set_buffer_size, METH_VARARGS|METH_KEYWORDS },
     { "get_buffer_size", (PyCFunction)py_io_channel_get_buffer_size, METH_NOARGS },
     { "read", (PyCFunction)py_io_channel_read_chars, METH_VARARGS|METH_KEYWORDS },
+    { "readinto", (PyCFunction)py_io_channel_readinto, METH_VARARGS|METH_KEYWORDS },
     { "readline", (PyCFunction)py_io_channel_read_line, METH_VARARGS|METH_KEYWORDS },
     { "readlines", (PyCFunction)py_io_channel_read_lines, METH_VARARGS|METH_KEYWORDS },
     { "write", (PyCFunction)py_io_channel_write_chars, METH_VARARGS|METH_KEYWORDS },
     { "writelines", (PyCFunction)py_io_channel_write_lines, METH_VARARGS|METH_KEYWORDS },
+    { "writev", (PyCFunction)py_io_channel_writev, METH_VARARGS|METH_KEYWORDS },
     { "set_flags", (PyCFunction)py_io_channel_set_flags, METH_VARARGS|METH_KEYWORDS },
     { "get_flags", (PyCFunction)py_io_channel_get_flags, METH_NOARGS },
     { "get_buffer_condition", (PyCFunction)py_io_channel_get_buffer_condition, METH_NOARGS },
     { "set_close_on_unref", (PyCFunction)py_io_channel_set_close_on_unref, METH_VARARGS | METH_KEYWORDS },
     { "get_close_on_unref", (PyCFunction)py_io_channel_get_close_on_unref, METH_NOARGS },
     { "add_watch", (PyCFunction)py_io_channel_add_watch, METH_VARARGS|METH_KEYWORDS },
+    { "add_line_watch", (PyCFunction)py_io_channel_add_line_watch, METH_VARARGS|METH_KEYWORDS },
     { "seek", (PyCFunction)py_io_channel_seek, METH_VARARGS|METH_KEYWORDS },
 #ifdef G_OS_WIN32
     { "win32_make_pollfd", (PyCFunction)py_io_channel_win32_make_pollfd, METH_VARARGS | METH_KEYWORDS },
@@ -37,11 +37,48 @@ struct _PyGLib_Functions {
     PyObject* (*main_context_new)(GMainContext *context);
     PyObject* (*option_context_new)(GOptionContext *context);
     PyObject* (*option_group_new)(GOptionGroup *group);
+    void (*freelist_register)(PyGLibFreeList *list);
+    void (*freelist_unregister)(PyGLibFreeList *list);
+    void (*gil_ensure_hook)(void);
 };
 
 gboolean _pyglib_handler_marshal(gpointer user_data);
 void _pyglib_destroy_notify(gpointer user_data);
 
+/* dispatch statistics, times in microseconds; histogram bucket i counts
+ * durations below 2^i us, the last one everything longer */
+#define PYGLIB_DISPATCH_HISTOGRAM_SIZE 24
+
+typedef struct {
+    guint id;
+    gchar *name;
+    gchar *callback;
+    guint64 count;
+    gint64 total_time;
+    gint64 max_time;
+    gint64 total_latency;
+    gint64 max_latency;
+    guint64 time_histogram[PYGLIB_DISPATCH_HISTOGRAM_SIZE];
+    guint64 latency_histogram[PYGLIB_DISPATCH_HISTOGRAM_SIZE];
+} PyGLibDispatchRecord;
+
+gint64 _pyglib_dispatch_stats_begin(void);
+void _pyglib_dispatch_stats_end(gint64 start, PyObject *callback);
+gboolean _pyglib_dispatch_stats_enable(GMainContext *context,
+				       guint max_sources);
+gboolean _pyglib_dispatch_stats_disable(GMainContext *context);
+GArray *_pyglib_dispatch_stats_snapshot(GMainContext *context,
+					gboolean reset);
+void _pyglib_dispatch_stats_free(GArray *records);
+
+#define PYGLIB_FREELIST_DEFAULT_LIMIT 128
+
+void _pyglib_freelist_register(PyGLibFreeList *list);
+void _pyglib_freelist_unregister(PyGLibFreeList *list);
+PyObject *_pyglib_freelist_get_stats(gboolean reset);
+guint _pyglib_freelist_get_limit(void);
+void _pyglib_freelist_set_limit(guint limit);
+
 G_END_DECLS
 
 #endif /* __PYGLIB_PRIVATE_H__ */
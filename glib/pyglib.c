@@ -89,6 +89,10 @@ pyglib_threads_enabled(void)
 PyGILState_STATE
 pyglib_gil_state_ensure(void)
 {
+#ifndef DISABLE_THREADING
+    PyGILState_STATE state;
+#endif
+
     g_return_val_if_fail (_PyGLib_API != NULL, PyGILState_LOCKED);
 
     if (!_PyGLib_API->threads_enabled)
@@ -97,10 +101,29 @@ pyglib_gil_state_ensure(void)
 #ifdef DISABLE_THREADING
     return PyGILState_LOCKED;
 #else
-    return PyGILState_Ensure();
+    state = PyGILState_Ensure();
+    if (G_UNLIKELY(_PyGLib_API->gil_ensure_hook != NULL))
+	_PyGLib_API->gil_ensure_hook();
+    return state;
 #endif
 }
 
+/**
+ * _pyglib_set_gil_ensure_hook:
+ * @hook: a function, or %NULL
+ *
+ * Sets a function called every time pyglib_gil_state_ensure() took
+ * the GIL, to run work other threads queued for the next time the
+ * binding holds it.
+ */
+void
+_pyglib_set_gil_ensure_hook(void (*hook)(void))
+{
+    g_return_if_fail (_PyGLib_API != NULL);
+
+    _PyGLib_API->gil_ensure_hook = hook;
+}
+
 void
 pyglib_gil_state_release(PyGILState_STATE state)
 {
@@ -492,6 +515,27 @@ pyglib_float_from_timeval(GTimeVal timeval)
     return PyFloat_FromDouble(ret);
 }
 
+/**
+ * _pyglib_get_monotonic_time:
+ *
+ * Returns the time of the monotonic clock, in microseconds, falling back
+ * to the wall clock on GLib versions that do not provide one.
+ *
+ * Returns: the current time in microseconds
+ */
+gint64
+_pyglib_get_monotonic_time(void)
+{
+#if GLIB_CHECK_VERSION(2, 28, 0)
+    return g_get_monotonic_time();
+#else
+    GTimeVal timeval;
+
+    g_get_current_time(&timeval);
+    return (gint64)timeval.tv_sec * G_USEC_PER_SEC + timeval.tv_usec;
+#endif
+}
+
 /**
  * pyg_pystr_to_gfilename_conv:
  *
@@ -597,12 +641,14 @@ _pyglib_handler_marshal(gpointer user_data)
     PyObject *tuple, *ret;
     gboolean res;
     PyGILState_STATE state;
+    gint64 start;
 
     g_return_val_if_fail(user_data != NULL, FALSE);
 
     state = pyglib_gil_state_ensure();
 
     tuple = (PyObject *)user_data;
+    start = _pyglib_dispatch_stats_begin();
     ret = PyObject_CallObject(PyTuple_GetItem(tuple, 0),
 			      PyTuple_GetItem(tuple, 1));
     if (!ret) {
@@ -612,6 +658,7 @@ _pyglib_handler_marshal(gpointer user_data)
 	res = PyObject_IsTrue(ret);
 	Py_DECREF(ret);
     }
+    _pyglib_dispatch_stats_end(start, PyTuple_GetItem(tuple, 0));
     
     pyglib_gil_state_release(state);
 
@@ -705,3 +752,617 @@ _pyglib_generic_long_richcompare(long a, long b, int op)
     return res;
 }
 
+
+/****** Dispatch statistics *****/
+
+/* Per main context dispatch statistics.  The statistics live in a
+ * GSource of their own, attached to the profiled context with the
+ * highest possible priority: it never dispatches, but its check function
+ * is the first one called once poll() returns, which gives the time the
+ * sources dispatched in this iteration were seen ready. */
+
+typedef struct {
+    GSource source;
+    GMainContext *context;
+    gint64 poll_time;
+    guint max_sources;
+    GHashTable *records;	/* source id -> PyGLibDispatchRecord */
+} PyGLibDispatchStats;
+
+G_LOCK_DEFINE_STATIC(dispatch_stats);
+static GHashTable *dispatch_stats_contexts = NULL;
+static volatile gint dispatch_stats_enabled = 0;
+
+static gboolean
+dispatch_stats_prepare(GSource *source, gint *timeout)
+{
+    *timeout = -1;
+    return FALSE;
+}
+
+static gboolean
+dispatch_stats_check(GSource *source)
+{
+    ((PyGLibDispatchStats *)source)->poll_time = _pyglib_get_monotonic_time();
+    return FALSE;
+}
+
+static gboolean
+dispatch_stats_dispatch(GSource *source, GSourceFunc callback,
+			gpointer user_data)
+{
+    return TRUE;
+}
+
+static void
+dispatch_stats_finalize(GSource *source)
+{
+    g_hash_table_destroy(((PyGLibDispatchStats *)source)->records);
+}
+
+static GSourceFuncs dispatch_stats_funcs = {
+    dispatch_stats_prepare,
+    dispatch_stats_check,
+    dispatch_stats_dispatch,
+    dispatch_stats_finalize
+};
+
+static void
+dispatch_record_free(gpointer data)
+{
+    PyGLibDispatchRecord *record = data;
+
+    g_free(record->name);
+    g_free(record->callback);
+    g_slice_free(PyGLibDispatchRecord, record);
+}
+
+static GHashTable *
+dispatch_records_new(void)
+{
+    return g_hash_table_new_full(g_direct_hash, g_direct_equal,
+				 NULL, dispatch_record_free);
+}
+
+static guint
+dispatch_histogram_bucket(gint64 usec)
+{
+    guint bucket = 0;
+
+    while (usec > 0 && bucket < PYGLIB_DISPATCH_HISTOGRAM_SIZE - 1) {
+	usec >>= 1;
+	bucket++;
+    }
+    return bucket;
+}
+
+/* "module.qualname" of a callback, or of its type when the callback is
+ * an instance (a glib.Source subclass for instance) */
+static gchar *
+dispatch_callback_name(PyObject *callback)
+{
+    PyObject *name, *module;
+    gchar *ret;
+
+    if (callback == NULL)
+	return NULL;
+
+#if PY_VERSION_HEX >= 0x03030000
+    name = PyObject_GetAttrString(callback, "__qualname__");
+#else
+    name = PyObject_GetAttrString(callback, "__name__");
+#endif
+    if (name == NULL || !PYGLIB_PyUnicode_Check(name)) {
+	PyErr_Clear();
+	Py_XDECREF(name);
+	callback = (PyObject *)Py_TYPE(callback);
+#if PY_VERSION_HEX >= 0x03030000
+	name = PyObject_GetAttrString(callback, "__qualname__");
+#else
+	name = PyObject_GetAttrString(callback, "__name__");
+#endif
+	if (name == NULL || !PYGLIB_PyUnicode_Check(name)) {
+	    PyErr_Clear();
+	    Py_XDECREF(name);
+	    return g_strdup(Py_TYPE(callback)->tp_name);
+	}
+    }
+
+    module = PyObject_GetAttrString(callback, "__module__");
+    if (module != NULL && PYGLIB_PyUnicode_Check(module))
+	ret = g_strconcat(PYGLIB_PyUnicode_AsString(module), ".",
+			  PYGLIB_PyUnicode_AsString(name), NULL);
+    else
+	ret = g_strdup(PYGLIB_PyUnicode_AsString(name));
+    PyErr_Clear();
+
+    Py_XDECREF(module);
+    Py_DECREF(name);
+    return ret;
+}
+
+/**
+ * _pyglib_dispatch_stats_begin:
+ *
+ * Called with the GIL held before a source callback runs.
+ *
+ * Returns: the dispatch start time to pass to
+ * _pyglib_dispatch_stats_end(), or 0 when no context is profiled
+ */
+gint64
+_pyglib_dispatch_stats_begin(void)
+{
+    if (G_LIKELY(!g_atomic_int_get(&dispatch_stats_enabled)))
+	return 0;
+    return _pyglib_get_monotonic_time();
+}
+
+/**
+ * _pyglib_dispatch_stats_end:
+ * @start: the value returned by _pyglib_dispatch_stats_begin()
+ * @callback: the Python callable that ran, or %NULL
+ *
+ * Called with the GIL held once a source callback returned, accounts the
+ * dispatch to the current source if its context is profiled.
+ */
+void
+_pyglib_dispatch_stats_end(gint64 start, PyObject *callback)
+{
+    PyGLibDispatchStats *stats;
+    PyGLibDispatchRecord *record;
+    GSource *source;
+    gint64 elapsed, ready_time = -1;
+    gchar *callback_name = NULL;
+    gboolean named = FALSE;
+    guint id;
+
+    if (G_LIKELY(start == 0))
+	return;
+
+    elapsed = _pyglib_get_monotonic_time() - start;
+    source = g_main_current_source();
+    if (source == NULL)
+	return;
+    id = g_source_get_id(source);
+#if GLIB_CHECK_VERSION(2, 36, 0)
+    ready_time = g_source_get_ready_time(source);
+#endif
+
+    for (;;) {
+	G_LOCK(dispatch_stats);
+	stats = NULL;
+	if (dispatch_stats_contexts != NULL)
+	    stats = g_hash_table_lookup(dispatch_stats_contexts,
+					g_source_get_context(source));
+	if (stats == NULL)
+	    break;
+
+	record = g_hash_table_lookup(stats->records, GUINT_TO_POINTER(id));
+	if (record == NULL &&
+	    g_hash_table_size(stats->records) >= stats->max_sources) {
+	    /* every source past the limit is accounted under id 0 */
+	    id = 0;
+	    record = g_hash_table_lookup(stats->records, GUINT_TO_POINTER(0));
+	    if (record == NULL) {
+		record = g_slice_new0(PyGLibDispatchRecord);
+		record->name = g_strdup("<overflow>");
+		g_hash_table_insert(stats->records, GUINT_TO_POINTER(0), record);
+	    }
+	}
+	if (record == NULL) {
+	    if (!named) {
+		/* naming the callback runs Python code, never do it
+		 * with the lock held */
+		G_UNLOCK(dispatch_stats);
+		callback_name = dispatch_callback_name(callback);
+		named = TRUE;
+		continue;
+	    }
+	    record = g_slice_new0(PyGLibDispatchRecord);
+	    record->id = id;
+#if GLIB_CHECK_VERSION(2, 26, 0)
+	    record->name = g_strdup(g_source_get_name(source));
+#endif
+	    record->callback = callback_name;
+	    callback_name = NULL;
+	    g_hash_table_insert(stats->records, GUINT_TO_POINTER(id), record);
+	}
+
+	record->count++;
+	record->total_time += elapsed;
+	if (elapsed > record->max_time)
+	    record->max_time = elapsed;
+	record->time_histogram[dispatch_histogram_bucket(elapsed)]++;
+
+	/* a source is ready once poll() returned, or at its ready time
+	 * when that expired first */
+	if (stats->poll_time != 0) {
+	    gint64 ready = stats->poll_time, latency;
+
+	    if (ready_time >= 0 && ready_time < ready)
+		ready = ready_time;
+	    latency = MAX(start - ready, 0);
+	    record->total_latency += latency;
+	    if (latency > record->max_latency)
+		record->max_latency = latency;
+	    record->latency_histogram[dispatch_histogram_bucket(latency)]++;
+	}
+	break;
+    }
+    G_UNLOCK(dispatch_stats);
+
+    g_free(callback_name);
+}
+
+/**
+ * _pyglib_dispatch_stats_enable:
+ * @context: a GMainContext
+ * @max_sources: the number of sources to keep separate records for
+ *
+ * Starts collecting dispatch statistics for @context.  Sources
+ * dispatched once @max_sources records exist are accounted together
+ * under id 0.
+ *
+ * Returns: %FALSE if statistics were already collected for @context
+ */
+gboolean
+_pyglib_dispatch_stats_enable(GMainContext *context, guint max_sources)
+{
+    PyGLibDispatchStats *stats;
+
+    stats = (PyGLibDispatchStats *)g_source_new(&dispatch_stats_funcs,
+						sizeof(PyGLibDispatchStats));
+    stats->context = g_main_context_ref(context);
+    stats->max_sources = MAX(max_sources, 1);
+    stats->records = dispatch_records_new();
+    g_source_set_priority((GSource *)stats, G_MININT);
+
+    G_LOCK(dispatch_stats);
+    if (dispatch_stats_contexts == NULL)
+	dispatch_stats_contexts = g_hash_table_new(g_direct_hash,
+						   g_direct_equal);
+    if (g_hash_table_lookup(dispatch_stats_contexts, context) != NULL) {
+	G_UNLOCK(dispatch_stats);
+	g_main_context_unref(stats->context);
+	g_source_unref((GSource *)stats);
+	return FALSE;
+    }
+    g_hash_table_insert(dispatch_stats_contexts, context, stats);
+    g_atomic_int_inc(&dispatch_stats_enabled);
+    G_UNLOCK(dispatch_stats);
+
+    g_source_attach((GSource *)stats, context);
+    return TRUE;
+}
+
+/**
+ * _pyglib_dispatch_stats_disable:
+ * @context: a GMainContext
+ *
+ * Stops collecting dispatch statistics for @context and drops them.
+ *
+ * Returns: %FALSE if no statistics were collected for @context
+ */
+gboolean
+_pyglib_dispatch_stats_disable(GMainContext *context)
+{
+    PyGLibDispatchStats *stats = NULL;
+
+    G_LOCK(dispatch_stats);
+    if (dispatch_stats_contexts != NULL)
+	stats = g_hash_table_lookup(dispatch_stats_contexts, context);
+    if (stats != NULL) {
+	g_hash_table_remove(dispatch_stats_contexts, context);
+	g_atomic_int_add(&dispatch_stats_enabled, -1);
+    }
+    G_UNLOCK(dispatch_stats);
+
+    if (stats == NULL)
+	return FALSE;
+
+    g_source_destroy((GSource *)stats);
+    g_main_context_unref(stats->context);
+    g_source_unref((GSource *)stats);
+    return TRUE;
+}
+
+/**
+ * _pyglib_dispatch_stats_snapshot:
+ * @context: a GMainContext
+ * @reset: whether to start over with empty statistics
+ *
+ * Copies the dispatch statistics of @context.  Only plain copies are
+ * made while the statistics are locked, so this is cheap to call from
+ * any thread, and with @reset the records are swapped out rather than
+ * copied.
+ *
+ * Returns: a GArray of PyGLibDispatchRecord to free with
+ * _pyglib_dispatch_stats_free(), or %NULL if no statistics are collected
+ * for @context
+ */
+GArray *
+_pyglib_dispatch_stats_snapshot(GMainContext *context, gboolean reset)
+{
+    PyGLibDispatchStats *stats = NULL;
+    GHashTable *records;
+    GHashTableIter iter;
+    PyGLibDispatchRecord *record, copy;
+    GArray *array;
+
+    G_LOCK(dispatch_stats);
+    if (dispatch_stats_contexts != NULL)
+	stats = g_hash_table_lookup(dispatch_stats_contexts, context);
+    if (stats == NULL) {
+	G_UNLOCK(dispatch_stats);
+	return NULL;
+    }
+
+    array = g_array_sized_new(FALSE, FALSE, sizeof(PyGLibDispatchRecord),
+			      g_hash_table_size(stats->records));
+    if (reset) {
+	records = stats->records;
+	stats->records = dispatch_records_new();
+	G_UNLOCK(dispatch_stats);
+
+	/* the strings move to the array */
+	g_hash_table_iter_init(&iter, records);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&record)) {
+	    g_array_append_val(array, *record);
+	    record->name = NULL;
+	    record->callback = NULL;
+	}
+	g_hash_table_destroy(records);
+	return array;
+    }
+
+    g_hash_table_iter_init(&iter, stats->records);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&record)) {
+	copy = *record;
+	copy.name = g_strdup(record->name);
+	copy.callback = g_strdup(record->callback);
+	g_array_append_val(array, copy);
+    }
+    G_UNLOCK(dispatch_stats);
+
+    return array;
+}
+
+void
+_pyglib_dispatch_stats_free(GArray *records)
+{
+    guint i;
+
+    for (i = 0; i < records->len; i++) {
+	PyGLibDispatchRecord *record;
+
+	record = &g_array_index(records, PyGLibDispatchRecord, i);
+	g_free(record->name);
+	g_free(record->callback);
+    }
+    g_array_free(records, TRUE);
+}
+
+
+/****** Wrapper free lists *****/
+
+/* Bounded free lists of wrapper instances for gobject and gi.  A list
+ * keeps the memory of deallocated instances of one layout, all of the
+ * same size and either all GC objects or none, and hands it to the next
+ * instance of that layout instead of going through the object
+ * allocator.  All of this runs with the GIL held.
+ *
+ * Each list belongs to the module creating it.  The registry behind the
+ * statistics and the limit is the one of the glib module, reached
+ * through _PyGLib_API, as every extension may link its own copy of this
+ * file.
+ *
+ * Python 3.11 keeps the dictionary and weak references of heap type
+ * instances in front of the object, where a reused block would carry
+ * stale values, so the lists stay empty there. */
+
+struct _PyGLibFreeList {
+    gchar *name;
+    gsize size;
+    gboolean gc;
+    gpointer head;		/* blocks linked through their first word */
+    guint length;
+    guint limit;
+    guint64 allocations;
+    guint64 hits;
+    guint64 releases;
+    guint64 kept;
+};
+
+static GSList *freelists = NULL;
+static guint freelist_limit = PYGLIB_FREELIST_DEFAULT_LIMIT;
+
+static void
+freelist_trim(PyGLibFreeList *list, guint limit)
+{
+    while (list->length > limit) {
+	gpointer block = list->head;
+
+	list->head = *(gpointer *)block;
+	list->length--;
+	if (list->gc)
+	    PyObject_GC_Del(block);
+	else
+	    PyObject_Free(block);
+    }
+}
+
+/**
+ * _pyglib_freelist_new:
+ * @name: the name the statistics report
+ * @size: the size of the instances
+ * @gc: whether the instances are GC objects
+ *
+ * Returns: a new, empty free list
+ */
+PyGLibFreeList *
+_pyglib_freelist_new(const gchar *name, gsize size, gboolean gc)
+{
+    PyGLibFreeList *list;
+
+    list = g_slice_new0(PyGLibFreeList);
+    list->name = g_strdup(name);
+    list->size = size;
+    list->gc = gc;
+    list->limit = PYGLIB_FREELIST_DEFAULT_LIMIT;
+    if (_PyGLib_API != NULL)
+	_PyGLib_API->freelist_register(list);
+    return list;
+}
+
+void
+_pyglib_freelist_destroy(PyGLibFreeList *list)
+{
+    if (_PyGLib_API != NULL)
+	_PyGLib_API->freelist_unregister(list);
+    freelist_trim(list, 0);
+    g_free(list->name);
+    g_slice_free(PyGLibFreeList, list);
+}
+
+/**
+ * _pyglib_freelist_pop:
+ * @list: a free list
+ * @type: the type of the new instance
+ *
+ * Takes a block from @list and initializes it as a new, zeroed and
+ * untracked instance of @type, as PyObject_New() and PyObject_GC_New()
+ * do.
+ *
+ * Returns: the instance, or %NULL with no exception set when @list is
+ * empty
+ */
+PyObject *
+_pyglib_freelist_pop(PyGLibFreeList *list, PyTypeObject *type)
+{
+    PyObject *self;
+
+    list->allocations++;
+#if PY_VERSION_HEX < 0x030B0000
+    if (list->head == NULL)
+	return NULL;
+
+    self = list->head;
+    list->head = *(gpointer *)self;
+    list->length--;
+    list->hits++;
+
+    memset(self, 0, list->size);
+    return PyObject_INIT(self, type);
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * _pyglib_freelist_push:
+ * @list: a free list
+ * @self: a deallocated instance, untracked, of the size of the list
+ *
+ * Called by tp_dealloc in place of tp_free.
+ *
+ * Returns: %TRUE when @list kept the memory of @self, %FALSE when the
+ * caller has to free it
+ */
+gboolean
+_pyglib_freelist_push(PyGLibFreeList *list, PyObject *self)
+{
+    list->releases++;
+#if PY_VERSION_HEX < 0x030B0000
+    if (list->length >= list->limit || Py_TYPE(self)->tp_del != NULL)
+	return FALSE;
+#if PY_VERSION_HEX >= 0x03040000
+    /* the collector marks finalized objects in their GC header, which a
+     * new instance must not inherit */
+    if (Py_TYPE(self)->tp_finalize != NULL)
+	return FALSE;
+#endif
+
+    *(gpointer *)self = list->head;
+    list->head = self;
+    list->length++;
+    list->kept++;
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+void
+_pyglib_freelist_register(PyGLibFreeList *list)
+{
+    list->limit = freelist_limit;
+    freelists = g_slist_prepend(freelists, list);
+}
+
+void
+_pyglib_freelist_unregister(PyGLibFreeList *list)
+{
+    freelists = g_slist_remove(freelists, list);
+}
+
+PyObject *
+_pyglib_freelist_get_stats(gboolean reset)
+{
+    PyObject *ret;
+    GSList *l;
+
+    ret = PyList_New(0);
+    if (ret == NULL)
+	return NULL;
+
+    for (l = freelists; l != NULL; l = l->next) {
+	PyGLibFreeList *list = l->data;
+	PyObject *item;
+
+	item = Py_BuildValue("{s:s,s:n,s:I,s:K,s:K,s:K,s:K}",
+			     "name", list->name,
+			     "size", (Py_ssize_t)list->size,
+			     "length", list->length,
+			     "allocations", list->allocations,
+			     "hits", list->hits,
+			     "releases", list->releases,
+			     "kept", list->kept);
+	if (item == NULL || PyList_Append(ret, item) < 0) {
+	    Py_XDECREF(item);
+	    Py_DECREF(ret);
+	    return NULL;
+	}
+	Py_DECREF(item);
+    }
+
+    if (reset) {
+	for (l = freelists; l != NULL; l = l->next) {
+	    PyGLibFreeList *list = l->data;
+
+	    list->allocations = list->hits = 0;
+	    list->releases = list->kept = 0;
+	}
+    }
+
+    return ret;
+}
+
+guint
+_pyglib_freelist_get_limit(void)
+{
+    return freelist_limit;
+}
+
+void
+_pyglib_freelist_set_limit(guint limit)
+{
+    GSList *l;
+
+    freelist_limit = limit;
+    for (l = freelists; l != NULL; l = l->next) {
+	PyGLibFreeList *list = l->data;
+
+	list->limit = limit;
+	freelist_trim(list, limit);
+    }
+}
@@ -60,6 +60,21 @@ void _pyglib_notify_on_enabling_threads(PyGLibThreadsEnabledFunc callback);
 PyObject* _pyglib_generic_ptr_richcompare(void* a, void *b, int op);
 PyObject* _pyglib_generic_long_richcompare(long a, long b, int op);
 
+/* Private: the monotonic clock used by the glib, gio and gi modules. */
+gint64 _pyglib_get_monotonic_time(void);
+
+/* Private: wrapper free lists shared by gobject and gi. */
+typedef struct _PyGLibFreeList PyGLibFreeList;
+PyGLibFreeList *_pyglib_freelist_new(const gchar *name, gsize size,
+				     gboolean gc);
+void _pyglib_freelist_destroy(PyGLibFreeList *list);
+PyObject *_pyglib_freelist_pop(PyGLibFreeList *list, PyTypeObject *type);
+gboolean _pyglib_freelist_push(PyGLibFreeList *list, PyObject *self);
+
+/* Private: lets gobject apply toggle notifications queued by threads
+   not holding the GIL. */
+void _pyglib_set_gil_ensure_hook(void (*hook)(void));
+
 #define pyglib_begin_allow_threads		\
     G_STMT_START {                              \
         PyThreadState *_save = NULL;            \
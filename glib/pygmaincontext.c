@@ -108,19 +108,174 @@ _wrap_g_main_context_pending (PyGMainContext *self)
     return PyBool_FromLong(g_main_context_pending(self->context));
 }
 
+static PyObject *
+_wrap_g_main_context_push_thread_default (PyGMainContext *self)
+{
+    g_main_context_push_thread_default(self->context);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+_wrap_g_main_context_pop_thread_default (PyGMainContext *self)
+{
+    g_main_context_pop_thread_default(self->context);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+_wrap_enable_dispatch_stats (PyGMainContext *self, PyObject *args,
+			     PyObject *kwargs)
+{
+    static char *kwlist[] = { "max_sources", NULL };
+    guint max_sources = 1024;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "|I:GMainContext.enable_dispatch_stats",
+				     kwlist, &max_sources))
+	return NULL;
+
+    return PyBool_FromLong(_pyglib_dispatch_stats_enable(self->context,
+							 max_sources));
+}
+
+static PyObject *
+_wrap_disable_dispatch_stats (PyGMainContext *self)
+{
+    return PyBool_FromLong(_pyglib_dispatch_stats_disable(self->context));
+}
+
+static PyObject *
+histogram_to_tuple(const guint64 *histogram)
+{
+    PyObject *tuple;
+    int i;
+
+    tuple = PyTuple_New(PYGLIB_DISPATCH_HISTOGRAM_SIZE);
+    if (tuple == NULL)
+	return NULL;
+    for (i = 0; i < PYGLIB_DISPATCH_HISTOGRAM_SIZE; i++)
+	PyTuple_SET_ITEM(tuple, i,
+			 PyLong_FromUnsignedLongLong(histogram[i]));
+    return tuple;
+}
+
+static PyObject *
+_wrap_get_dispatch_stats (PyGMainContext *self, PyObject *args,
+			  PyObject *kwargs)
+{
+    static char *kwlist[] = { "reset", NULL };
+    PyObject *py_reset = Py_False, *list;
+    GArray *records;
+    guint i;
+    int reset;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "|O:GMainContext.get_dispatch_stats",
+				     kwlist, &py_reset))
+	return NULL;
+
+    reset = PyObject_IsTrue(py_reset);
+    if (reset < 0)
+	return NULL;
+
+    /* the snapshot never waits for Python, release the GIL while the
+     * dispatching thread may hold the statistics lock */
+    pyglib_begin_allow_threads;
+    records = _pyglib_dispatch_stats_snapshot(self->context, reset);
+    pyglib_end_allow_threads;
+
+    list = PyList_New(0);
+    if (list == NULL || records == NULL)
+	goto out;
+
+    for (i = 0; i < records->len; i++) {
+	PyGLibDispatchRecord *record;
+	PyObject *item;
+
+	record = &g_array_index(records, PyGLibDispatchRecord, i);
+	item = Py_BuildValue("{s:I,s:z,s:z,s:K,s:d,s:d,s:d,s:d,s:N,s:N}",
+			     "id", record->id,
+			     "name", record->name,
+			     "callback", record->callback,
+			     "count", record->count,
+			     "total_time", record->total_time / 1e6,
+			     "max_time", record->max_time / 1e6,
+			     "total_latency", record->total_latency / 1e6,
+			     "max_latency", record->max_latency / 1e6,
+			     "time_histogram",
+			     histogram_to_tuple(record->time_histogram),
+			     "latency_histogram",
+			     histogram_to_tuple(record->latency_histogram));
+	if (item == NULL || PyList_Append(list, item) < 0) {
+	    Py_XDECREF(item);
+	    Py_CLEAR(list);
+	    break;
+	}
+	Py_DECREF(item);
+    }
+
+out:
+    if (records != NULL)
+	_pyglib_dispatch_stats_free(records);
+    return list;
+}
+
+static PyObject *
+_wrap_reset_dispatch_stats (PyGMainContext *self)
+{
+    GArray *records;
+
+    pyglib_begin_allow_threads;
+    records = _pyglib_dispatch_stats_snapshot(self->context, TRUE);
+    if (records != NULL)
+	_pyglib_dispatch_stats_free(records);
+    pyglib_end_allow_threads;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyMethodDef _PyGMainContext_methods[] = {
     { "iteration", (PyCFunction)_wrap_g_main_context_iteration, METH_VARARGS },
     { "pending", (PyCFunction)_wrap_g_main_context_pending, METH_NOARGS },
+    { "push_thread_default",
+      (PyCFunction)_wrap_g_main_context_push_thread_default, METH_NOARGS },
+    { "pop_thread_default",
+      (PyCFunction)_wrap_g_main_context_pop_thread_default, METH_NOARGS },
+    { "enable_dispatch_stats", (PyCFunction)_wrap_enable_dispatch_stats,
+      METH_VARARGS|METH_KEYWORDS },
+    { "disable_dispatch_stats", (PyCFunction)_wrap_disable_dispatch_stats,
+      METH_NOARGS },
+    { "get_dispatch_stats", (PyCFunction)_wrap_get_dispatch_stats,
+      METH_VARARGS|METH_KEYWORDS },
+    { "reset_dispatch_stats", (PyCFunction)_wrap_reset_dispatch_stats,
+      METH_NOARGS },
     { NULL, NULL, 0 }
 };
 
 void
 pyglib_maincontext_register_types(PyObject *d)
 {
+    PyObject *bounds;
+    int i;
+
     PyGMainContext_Type.tp_dealloc = (destructor)pyg_main_context_dealloc;
     PyGMainContext_Type.tp_richcompare = pyg_main_context_richcompare;
     PyGMainContext_Type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
     PyGMainContext_Type.tp_methods = _PyGMainContext_methods;
     PyGMainContext_Type.tp_init = (initproc)pyg_main_context_init;
     PYGLIB_REGISTER_TYPE(d, PyGMainContext_Type, "MainContext"); 
+
+    /* upper bounds of the dispatch statistics histogram buckets, in
+     * seconds */
+    bounds = PyTuple_New(PYGLIB_DISPATCH_HISTOGRAM_SIZE);
+    for (i = 0; i < PYGLIB_DISPATCH_HISTOGRAM_SIZE - 1; i++)
+	PyTuple_SET_ITEM(bounds, i, PyFloat_FromDouble((1 << i) / 1e6));
+    PyTuple_SET_ITEM(bounds, i, PyFloat_FromDouble(Py_HUGE_VAL));
+    PyDict_SetItemString(d, "DISPATCH_HISTOGRAM_BOUNDS", bounds);
+    Py_DECREF(bounds);
 }
@@ -43,20 +43,38 @@
 } G_STMT_END
 
 
-typedef struct {
-    PyObject_HEAD
-    GSource *source;
-    PyObject *inst_dict;
-    PyObject *weakreflist;
-    gboolean python_source;
-} PyGSource;
+/* methods a glib.Source subclass implements; the others are handled in C
+ * without taking the GIL */
+#define PYG_SOURCE_PREPARE  (1 << 0)
+#define PYG_SOURCE_CHECK    (1 << 1)
+#define PYG_SOURCE_DISPATCH (1 << 2)
+#define PYG_SOURCE_FINALIZE (1 << 3)
 
 typedef struct
 {
     GSource source;
     PyObject *obj;
+    guint overrides;
+    gint64 ready_time;
 } PyGRealSource;
 
+static guint
+pyg_source_get_overrides(PyObject *obj)
+{
+    guint overrides = 0;
+
+    if (PyObject_HasAttrString(obj, "prepare"))
+	overrides |= PYG_SOURCE_PREPARE;
+    if (PyObject_HasAttrString(obj, "check"))
+	overrides |= PYG_SOURCE_CHECK;
+    if (PyObject_HasAttrString(obj, "dispatch"))
+	overrides |= PYG_SOURCE_DISPATCH;
+    if (PyObject_HasAttrString(obj, "finalize"))
+	overrides |= PYG_SOURCE_FINALIZE;
+
+    return overrides;
+}
+
 /* glib.Source */
 
 PYGLIB_DEFINE_TYPE("glib.Source", PyGSource_Type, PyGSource)
@@ -106,6 +124,7 @@ pyg_source_attach(PyGSource *self, PyObject *args, PyObject *kwargs)
     if (self->python_source) {
 	PyGRealSource *pysource = (PyGRealSource *)self->source;
 	Py_INCREF(pysource->obj);
+	pysource->overrides = pyg_source_get_overrides(pysource->obj);
     }
 
     id = g_source_attach(self->source, context);
@@ -254,6 +273,63 @@ pyg_source_get_current_time(PyGSource *self)
     return PyFloat_FromDouble(ret);
 }
 
+static PyObject *
+pyg_source_set_ready_time(PyGSource *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "ready_time", NULL };
+    PyGRealSource *pysource;
+    GMainContext *context;
+    PY_LONG_LONG ready_time;
+
+    if (!self->python_source) {
+	PyErr_SetString(PyExc_TypeError,
+			"set_ready_time can only be used with sources "
+			"implemented in python");
+	return NULL;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "L:set_ready_time", kwlist,
+				     &ready_time))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+    pysource = (PyGRealSource *)self->source;
+    pysource->ready_time = ready_time < 0 ? -1 : ready_time;
+
+    /* the main loop may be sleeping on an earlier timeout */
+    context = g_source_get_context(self->source);
+    if (context)
+	g_main_context_wakeup(context);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_source_get_ready_time(PyGSource *self)
+{
+    if (!self->python_source) {
+	PyErr_SetString(PyExc_TypeError,
+			"get_ready_time can only be used with sources "
+			"implemented in python");
+	return NULL;
+    }
+
+    CHECK_DESTROYED(self, NULL);
+
+    return PyLong_FromLongLong(((PyGRealSource *)self->source)->ready_time);
+}
+
+static PyObject *
+pyg_source_get_time(PyGSource *self)
+{
+    CHECK_DESTROYED(self, NULL);
+
+    return PyLong_FromLongLong(_pyglib_get_monotonic_time());
+}
+
 static PyMethodDef pyg_source_methods[] = {
     { "attach", (PyCFunction)pyg_source_attach, METH_VARARGS|METH_KEYWORDS },
     { "destroy", (PyCFunction)pyg_source_destroy, METH_NOARGS },
@@ -262,6 +338,9 @@ static PyMethodDef pyg_source_methods[] = {
     { "add_poll", (PyCFunction)pyg_source_add_poll, METH_VARARGS | METH_KEYWORDS },
     { "remove_poll", (PyCFunction)pyg_source_remove_poll, METH_VARARGS|METH_KEYWORDS },
     { "get_current_time", (PyCFunction)pyg_source_get_current_time, METH_NOARGS },
+    { "set_ready_time", (PyCFunction)pyg_source_set_ready_time, METH_VARARGS|METH_KEYWORDS },
+    { "get_ready_time", (PyCFunction)pyg_source_get_ready_time, METH_NOARGS },
+    { "get_time", (PyCFunction)pyg_source_get_time, METH_NOARGS },
     { NULL, NULL, 0 }
 };
 
@@ -399,9 +478,8 @@ pyg_source_dealloc(PyGSource *self)
 }
 
 static gboolean
-pyg_source_prepare(GSource *source, gint *timeout)
+pyg_source_call_prepare(PyGRealSource *pysource, gint *timeout)
 {
-    PyGRealSource *pysource = (PyGRealSource *)source;
     PyObject *t;
     gboolean ret = FALSE;
     gboolean got_err = TRUE;
@@ -448,6 +526,49 @@ bail:
     return ret;
 }
 
+static gboolean
+pyg_source_prepare(GSource *source, gint *timeout)
+{
+    PyGRealSource *pysource = (PyGRealSource *)source;
+    gboolean ret = FALSE;
+
+    if (pysource->overrides & PYG_SOURCE_PREPARE)
+	ret = pyg_source_call_prepare(pysource, timeout);
+
+    if (!ret && pysource->ready_time >= 0) {
+	gint64 remaining;
+
+	remaining = pysource->ready_time - _pyglib_get_monotonic_time();
+	if (remaining <= 0) {
+	    ret = TRUE;
+	} else {
+	    gint ready_timeout = (gint)MIN((remaining + 999) / 1000, G_MAXINT);
+
+	    if (*timeout < 0 || ready_timeout < *timeout)
+		*timeout = ready_timeout;
+	}
+    }
+
+    return ret;
+}
+
+/* default check: ready when one of the fds added with add_poll() got one
+ * of the events it asked for */
+static gboolean
+pyg_source_poll_fds_ready(GSource *source)
+{
+    GSList *tmp;
+
+    for (tmp = source->poll_fds; tmp != NULL; tmp = tmp->next) {
+	GPollFD *pollfd = tmp->data;
+
+	if (pollfd->revents & (pollfd->events | G_IO_ERR | G_IO_HUP))
+	    return TRUE;
+    }
+
+    return FALSE;
+}
+
 static gboolean
 pyg_source_check(GSource *source)
 {
@@ -456,19 +577,26 @@ pyg_source_check(GSource *source)
     gboolean ret;
     PyGILState_STATE state;
 
-    state = pyglib_gil_state_ensure();
+    if (!(pysource->overrides & PYG_SOURCE_CHECK)) {
+	ret = pyg_source_poll_fds_ready(source);
+    } else {
+	state = pyglib_gil_state_ensure();
 
-    t = PyObject_CallMethod(pysource->obj, "check", NULL);
+	t = PyObject_CallMethod(pysource->obj, "check", NULL);
 
-    if (t == NULL) {
-	PyErr_Print();
-	ret = FALSE;
-    } else {
-	ret = PyObject_IsTrue(t);
-	Py_DECREF(t);
+	if (t == NULL) {
+	    PyErr_Print();
+	    ret = FALSE;
+	} else {
+	    ret = PyObject_IsTrue(t);
+	    Py_DECREF(t);
+	}
+
+	pyglib_gil_state_release(state);
     }
 
-    pyglib_gil_state_release(state);
+    if (!ret && pysource->ready_time >= 0)
+	ret = _pyglib_get_monotonic_time() >= pysource->ready_time;
 
     return ret;
 }
@@ -480,6 +608,15 @@ pyg_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
     PyObject *func, *args, *tuple, *t;
     gboolean ret;
     PyGILState_STATE state;
+    gint64 start;
+
+    if (!(pysource->overrides & PYG_SOURCE_DISPATCH)) {
+	/* no dispatch method, run the callback set with set_callback();
+	 * _pyglib_handler_marshal takes care of the GIL */
+	if (callback)
+	    return callback(user_data);
+	return FALSE;
+    }
 
     state = pyglib_gil_state_ensure();
 
@@ -493,6 +630,7 @@ pyg_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
 	args = Py_None;
     }
 
+    start = _pyglib_dispatch_stats_begin();
     t = PyObject_CallMethod(pysource->obj, "dispatch", "OO", func, args);
 
     if (t == NULL) {
@@ -502,6 +640,8 @@ pyg_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
 	ret = PyObject_IsTrue(t);
 	Py_DECREF(t);
     }
+    /* account the dispatch to the Source subclass */
+    _pyglib_dispatch_stats_end(start, pysource->obj);
 
     pyglib_gil_state_release(state);
 
@@ -515,6 +655,9 @@ pyg_source_finalize(GSource *source)
     PyObject *func, *t;
     PyGILState_STATE state;
 
+    if (!(pysource->overrides & PYG_SOURCE_FINALIZE))
+	return;
+
     state = pyglib_gil_state_ensure();
 
     func = PyObject_GetAttrString(pysource->obj, "finalize");
@@ -527,6 +670,8 @@ pyg_source_finalize(GSource *source)
 	} else {
 	    Py_DECREF(t);
 	}
+    } else {
+	PyErr_Print();
     }
 
     pyglib_gil_state_release(state);
@@ -549,6 +694,8 @@ pyg_source_init(PyGSource *self, PyObject *args, PyObject *kwargs)
 
     pysource = (PyGRealSource *)self->source;
     pysource->obj = (PyObject*)self;
+    pysource->overrides = pyg_source_get_overrides((PyObject*)self);
+    pysource->ready_time = -1;
 
     self->inst_dict = NULL;
     self->weakreflist = NULL;
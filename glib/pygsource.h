@@ -27,6 +27,14 @@ extern PyTypeObject PyGIdle_Type;
 extern PyTypeObject PyGTimeout_Type;
 extern PyTypeObject PyGPollFD_Type;
 
+typedef struct {
+    PyObject_HEAD
+    GSource *source;
+    PyObject *inst_dict;
+    PyObject *weakreflist;
+    gboolean python_source;
+} PyGSource;
+
 typedef struct
 {
     PyObject_HEAD
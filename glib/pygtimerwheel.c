@@ -0,0 +1,817 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * pyglib - Python bindings for GLib toolkit.
+ * Copyright (C) 1998-2003  James Henstridge
+ *               2004-2008  Johan Dahlin
+ *
+ *   pygtimerwheel.c: hierarchical timer wheel GSource
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301
+ * USA
+ */
+
+/*
+ * A glib.TimerWheel multiplexes any number of Python timers onto a single
+ * GSource, so the main loop only pays for one source in prepare/check no
+ * matter how many timeouts are pending.
+ *
+ * Timers live in a four level hashed wheel of 256 slots each (the classic
+ * cascading layout): level 0 holds timers expiring within 256 ticks, level 1
+ * within 65536 ticks and so on.  Adding and removing a timer are O(1), and a
+ * higher level slot is redistributed ("cascaded") into the lower levels when
+ * the wheel reaches it.  Expired timers are moved to a separate list which is
+ * drained in a single dispatch, taking the GIL only once per batch.
+ *
+ * Timer ids are allocated downwards from G_MAXINT so that they do not clash
+ * with GSource ids, which GLib allocates upwards from 1; this lets
+ * glib.source_remove() accept both kinds.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <Python.h>
+#include <pythread.h>
+#include "pyglib.h"
+#include "pyglib-private.h"
+#include "pygsource.h"
+#include "pygtimerwheel.h"
+
+#define WHEEL_BITS      8
+#define WHEEL_SLOTS     (1 << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS    4
+#define WHEEL_MAX_DELTA (G_GUINT64_CONSTANT(1) << (WHEEL_BITS * WHEEL_LEVELS))
+
+/* values of PyGTimer.level when the timer is not sitting in a slot */
+#define TIMER_EXPIRED  -1
+#define TIMER_RUNNING  -2
+#define TIMER_DETACHED -3
+
+#define CHECK_DESTROYED(self, ret)			G_STMT_START {	\
+    if ((self)->source == NULL) {					\
+	PyErr_SetString(PyExc_RuntimeError, "source is destroyed");	\
+	return (ret);							\
+    }									\
+} G_STMT_END
+
+typedef struct _PyGTimerLink PyGTimerLink;
+typedef struct _PyGTimer PyGTimer;
+typedef struct _PyGTimerWheelSource PyGTimerWheelSource;
+
+struct _PyGTimerLink {
+    PyGTimerLink *prev;
+    PyGTimerLink *next;
+};
+
+struct _PyGTimer {
+    PyGTimerLink link;		/* must be first */
+    PyGTimerWheelSource *wheel;
+    guint64 expires;		/* in ticks */
+    guint64 interval;		/* in milliseconds */
+    guint id;
+    gint level;
+    gint slot;
+    gboolean removed;
+    PyObject *data;		/* (callback, args) */
+};
+
+struct _PyGTimerWheelSource {
+    GSource source;
+    guint64 tick_usec;
+    guint64 slack;		/* in ticks */
+    gint64 start;		/* monotonic time of tick 0 */
+    guint64 current;		/* last tick the wheel advanced to */
+    guint64 next_expiry;	/* as computed by the last prepare() */
+    guint n_scheduled;		/* timers sitting in slots */
+    guint n_pending;		/* timers not yet removed */
+    gboolean dispatching;
+    PyGTimer *running;		/* timer whose callback is being called */
+    guint64 bitmap[WHEEL_LEVELS][WHEEL_SLOTS / 64];
+    PyGTimerLink slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    PyGTimerLink expired;
+};
+
+/* Protects every wheel and the id table.  prepare() and check() run
+ * without the GIL, so the GIL alone is not enough; the lock is never held
+ * while calling into Python or while taking the GIL. */
+G_LOCK_DEFINE_STATIC(timer_wheel);
+static GHashTable *timer_ids = NULL;
+static guint next_timer_id = G_MAXINT;
+
+static guint64
+wheel_tick_at(PyGTimerWheelSource *wheel, gint64 now)
+{
+    if (now <= wheel->start)
+	return 0;
+    return (guint64)(now - wheel->start) / wheel->tick_usec;
+}
+
+static void
+link_init(PyGTimerLink *link)
+{
+    link->prev = link->next = link;
+}
+
+static gboolean
+link_is_empty(PyGTimerLink *head)
+{
+    return head->next == head;
+}
+
+static void
+link_append(PyGTimerLink *head, PyGTimerLink *link)
+{
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+static void
+link_remove(PyGTimerLink *link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link_init(link);
+}
+
+#define BITMAP_WORD(slot) ((slot) >> 6)
+#define BITMAP_BIT(slot)  (G_GUINT64_CONSTANT(1) << ((slot) & 63))
+
+static void
+wheel_insert(PyGTimerWheelSource *wheel, PyGTimer *timer)
+{
+    guint64 expires = timer->expires, delta;
+    gint level, slot;
+
+    if (expires <= wheel->current) {
+	link_append(&wheel->expired, &timer->link);
+	timer->level = TIMER_EXPIRED;
+	return;
+    }
+
+    delta = expires - wheel->current;
+    if (delta >= WHEEL_MAX_DELTA) {
+	/* park it in the last slot of the top level, it gets re-evaluated
+	 * when that slot is cascaded */
+	expires = wheel->current + WHEEL_MAX_DELTA - 1;
+	delta = WHEEL_MAX_DELTA - 1;
+    }
+
+    for (level = 0; level < WHEEL_LEVELS - 1; level++)
+	if (delta < (G_GUINT64_CONSTANT(1) << (WHEEL_BITS * (level + 1))))
+	    break;
+
+    slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    link_append(&wheel->slots[level][slot], &timer->link);
+    wheel->bitmap[level][BITMAP_WORD(slot)] |= BITMAP_BIT(slot);
+    timer->level = level;
+    timer->slot = slot;
+    wheel->n_scheduled++;
+}
+
+static void
+wheel_unlink(PyGTimerWheelSource *wheel, PyGTimer *timer)
+{
+    link_remove(&timer->link);
+
+    if (timer->level >= 0) {
+	if (link_is_empty(&wheel->slots[timer->level][timer->slot]))
+	    wheel->bitmap[timer->level][BITMAP_WORD(timer->slot)] &=
+		~BITMAP_BIT(timer->slot);
+	wheel->n_scheduled--;
+    }
+    timer->level = TIMER_DETACHED;
+}
+
+/* Redistributes the slot of @level the wheel just reached, returns the
+ * index of that slot. */
+static gint
+wheel_cascade(PyGTimerWheelSource *wheel, gint level)
+{
+    gint slot = (wheel->current >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    PyGTimerLink *head = &wheel->slots[level][slot], list;
+
+    if (link_is_empty(head))
+	return slot;
+
+    /* steal the whole slot first, timers may land in it again */
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    link_init(head);
+    wheel->bitmap[level][BITMAP_WORD(slot)] &= ~BITMAP_BIT(slot);
+
+    while (!link_is_empty(&list)) {
+	PyGTimer *timer = (PyGTimer *)list.next;
+
+	link_remove(&timer->link);
+	wheel->n_scheduled--;
+	wheel_insert(wheel, timer);
+    }
+
+    return slot;
+}
+
+static gboolean
+wheel_level_is_empty(PyGTimerWheelSource *wheel, gint level)
+{
+    gint i;
+
+    for (i = 0; i < WHEEL_SLOTS / 64; i++)
+	if (wheel->bitmap[level][i])
+	    return FALSE;
+    return TRUE;
+}
+
+/* Moves the wheel forward to @target, putting every timer that expires on
+ * the way on the expired list. */
+static void
+wheel_advance(PyGTimerWheelSource *wheel, guint64 target)
+{
+    while (wheel->current < target) {
+	PyGTimerLink *head;
+	gint level;
+
+	if (wheel->n_scheduled == 0) {
+	    wheel->current = target;
+	    break;
+	}
+
+	for (level = 0; level < WHEEL_LEVELS - 1; level++)
+	    if (!wheel_level_is_empty(wheel, level))
+		break;
+
+	if (level > 0) {
+	    /* the lower levels are empty: nothing can happen before the
+	     * next slot of @level gets cascaded */
+	    guint64 mask = (G_GUINT64_CONSTANT(1) << (WHEEL_BITS * level)) - 1;
+	    guint64 boundary = (wheel->current | mask) + 1;
+
+	    if (boundary > target) {
+		wheel->current = target;
+		break;
+	    }
+	    wheel->current = boundary;
+	} else {
+	    wheel->current++;
+	}
+
+	if ((wheel->current & WHEEL_MASK) == 0) {
+	    for (level = 1; level < WHEEL_LEVELS; level++)
+		if (wheel_cascade(wheel, level) != 0)
+		    break;
+	}
+
+	head = &wheel->slots[0][wheel->current & WHEEL_MASK];
+	while (!link_is_empty(head)) {
+	    PyGTimer *timer = (PyGTimer *)head->next;
+
+	    wheel_unlink(wheel, timer);
+	    link_append(&wheel->expired, &timer->link);
+	    timer->level = TIMER_EXPIRED;
+	}
+    }
+}
+
+/* Returns the first tick at which the wheel has work to do: either a timer
+ * expiring or a higher level slot that has to be cascaded. */
+static guint64
+wheel_next_expiry(PyGTimerWheelSource *wheel)
+{
+    guint64 next = G_MAXUINT64;
+    gint level;
+
+    if (!link_is_empty(&wheel->expired))
+	return wheel->current;
+    if (wheel->n_scheduled == 0)
+	return next;
+
+    for (level = 0; level < WHEEL_LEVELS; level++) {
+	gint shift = WHEEL_BITS * level;
+	guint64 base = wheel->current >> shift;
+	guint distance;
+
+	for (distance = 1; distance <= WHEEL_SLOTS; distance++) {
+	    gint slot = (base + distance) & WHEEL_MASK;
+
+	    if (wheel->bitmap[level][BITMAP_WORD(slot)] & BITMAP_BIT(slot)) {
+		guint64 when = (base + distance) << shift;
+
+		if (when < next)
+		    next = when;
+		break;
+	    }
+	}
+    }
+
+    return next;
+}
+
+/* Converts a relative interval to the tick the timer should fire at; a
+ * timer never fires early, and with slack it is rounded up so that timers
+ * due around the same time share a wakeup. */
+static guint64
+wheel_deadline(PyGTimerWheelSource *wheel, gint64 now, guint64 interval)
+{
+    guint64 deadline, expires;
+
+    deadline = interval * 1000;
+    if (now > wheel->start)
+	deadline += (guint64)(now - wheel->start);
+    expires = (deadline + wheel->tick_usec - 1) / wheel->tick_usec;
+    if (wheel->slack > 1)
+	expires = ((expires + wheel->slack - 1) / wheel->slack) * wheel->slack;
+
+    return MAX(expires, wheel->current + 1);
+}
+
+static guint
+timer_id_new(void)
+{
+    guint id;
+
+    do {
+	id = next_timer_id--;
+	if (next_timer_id == 0)
+	    next_timer_id = G_MAXINT;
+    } while (g_hash_table_lookup(timer_ids, GUINT_TO_POINTER(id)) != NULL);
+
+    return id;
+}
+
+/* must be called with the GIL held and the wheel lock released */
+static void
+timer_free(PyGTimer *timer)
+{
+    Py_DECREF(timer->data);
+    g_slice_free(PyGTimer, timer);
+}
+
+static guint
+wheel_add_timer(PyGTimerWheelSource *wheel, guint64 interval, PyObject *data)
+{
+    PyGTimer *timer;
+    GMainContext *context = NULL;
+    gint64 now;
+    guint id;
+
+    timer = g_slice_new0(PyGTimer);
+    timer->wheel = wheel;
+    timer->interval = interval;
+    timer->data = data;
+
+    now = _pyglib_get_monotonic_time();
+
+    G_LOCK(timer_wheel);
+    wheel_advance(wheel, wheel_tick_at(wheel, now));
+
+    timer->expires = wheel_deadline(wheel, now, interval);
+    timer->id = id = timer_id_new();
+    g_hash_table_insert(timer_ids, GUINT_TO_POINTER(id), timer);
+    wheel_insert(wheel, timer);
+    wheel->n_pending++;
+
+    /* the main loop may be sleeping on a later deadline */
+    if (!wheel->dispatching && timer->expires < wheel->next_expiry) {
+	wheel->next_expiry = timer->expires;
+	context = g_source_get_context(&wheel->source);
+    }
+    G_UNLOCK(timer_wheel);
+
+    if (context)
+	g_main_context_wakeup(context);
+
+    return id;
+}
+
+/* must be called with the GIL held */
+static gboolean
+wheel_remove_id(PyGTimerWheelSource *wheel, guint id)
+{
+    PyGTimer *timer;
+    gboolean free_timer = FALSE;
+
+    if (timer_ids == NULL)
+	return FALSE;
+
+    G_LOCK(timer_wheel);
+    timer = g_hash_table_lookup(timer_ids, GUINT_TO_POINTER(id));
+    if (timer == NULL || (wheel != NULL && timer->wheel != wheel)) {
+	G_UNLOCK(timer_wheel);
+	return FALSE;
+    }
+
+    g_hash_table_remove(timer_ids, GUINT_TO_POINTER(id));
+    timer->wheel->n_pending--;
+
+    if (timer->level == TIMER_RUNNING) {
+	/* freed by dispatch once the callback returns */
+	timer->removed = TRUE;
+    } else {
+	wheel_unlink(timer->wheel, timer);
+	free_timer = TRUE;
+    }
+    G_UNLOCK(timer_wheel);
+
+    if (free_timer)
+	timer_free(timer);
+
+    return TRUE;
+}
+
+/**
+ * pyg_timer_wheel_remove_id:
+ * @id: a timer id as returned by glib.TimerWheel.add().
+ *
+ * Removes a timer from whichever wheel it was added to.  Must be called
+ * with the GIL held.
+ *
+ * Returns: TRUE if @id was a pending timer wheel timer.
+ */
+gboolean
+pyg_timer_wheel_remove_id(guint id)
+{
+    return wheel_remove_id(NULL, id);
+}
+
+static gboolean
+pyg_timer_wheel_prepare(GSource *source, gint *timeout)
+{
+    PyGTimerWheelSource *wheel = (PyGTimerWheelSource *)source;
+    gboolean ready;
+    gint64 now;
+
+    now = _pyglib_get_monotonic_time();
+
+    G_LOCK(timer_wheel);
+    wheel_advance(wheel, wheel_tick_at(wheel, now));
+
+    ready = !link_is_empty(&wheel->expired);
+    wheel->next_expiry = wheel_next_expiry(wheel);
+
+    if (ready) {
+	*timeout = 0;
+    } else if (wheel->next_expiry == G_MAXUINT64) {
+	*timeout = -1;
+    } else {
+	gint64 remaining;
+
+	remaining = wheel->start +
+	    (gint64)(wheel->next_expiry * wheel->tick_usec) - now;
+	if (remaining <= 0)
+	    *timeout = 0;
+	else
+	    *timeout = (gint)MIN((remaining + 999) / 1000, G_MAXINT);
+    }
+    G_UNLOCK(timer_wheel);
+
+    return ready;
+}
+
+static gboolean
+pyg_timer_wheel_check(GSource *source)
+{
+    PyGTimerWheelSource *wheel = (PyGTimerWheelSource *)source;
+    gboolean ready;
+    gint64 now;
+
+    now = _pyglib_get_monotonic_time();
+
+    G_LOCK(timer_wheel);
+    wheel_advance(wheel, wheel_tick_at(wheel, now));
+    ready = !link_is_empty(&wheel->expired);
+    G_UNLOCK(timer_wheel);
+
+    return ready;
+}
+
+static gboolean
+pyg_timer_wheel_dispatch(GSource *source, GSourceFunc callback,
+			 gpointer user_data)
+{
+    PyGTimerWheelSource *wheel = (PyGTimerWheelSource *)source;
+    PyGILState_STATE state;
+
+    state = pyglib_gil_state_ensure();
+
+    G_LOCK(timer_wheel);
+    wheel->dispatching = TRUE;
+
+    while (!link_is_empty(&wheel->expired)) {
+	PyGTimer *timer = (PyGTimer *)wheel->expired.next;
+	PyObject *ret;
+	gboolean again;
+
+	link_remove(&timer->link);
+	timer->level = TIMER_RUNNING;
+	wheel->running = timer;
+	G_UNLOCK(timer_wheel);
+
+	ret = PyObject_CallObject(PyTuple_GET_ITEM(timer->data, 0),
+				  PyTuple_GET_ITEM(timer->data, 1));
+	if (!ret) {
+	    PyErr_Print();
+	    again = FALSE;
+	} else {
+	    again = PyObject_IsTrue(ret);
+	    Py_DECREF(ret);
+	}
+
+	G_LOCK(timer_wheel);
+	wheel->running = NULL;
+	if (again && !timer->removed) {
+	    timer->expires = wheel_deadline(wheel,
+					    _pyglib_get_monotonic_time(),
+					    timer->interval);
+	    wheel_insert(wheel, timer);
+	    continue;
+	}
+
+	if (!timer->removed) {
+	    g_hash_table_remove(timer_ids, GUINT_TO_POINTER(timer->id));
+	    wheel->n_pending--;
+	}
+	timer->level = TIMER_DETACHED;
+	G_UNLOCK(timer_wheel);
+
+	timer_free(timer);
+
+	G_LOCK(timer_wheel);
+    }
+
+    wheel->dispatching = FALSE;
+    G_UNLOCK(timer_wheel);
+
+    pyglib_gil_state_release(state);
+
+    return TRUE;
+}
+
+static void
+wheel_drain(PyGTimerWheelSource *wheel, PyGTimerLink *head, PyGTimerLink *dead)
+{
+    while (!link_is_empty(head)) {
+	PyGTimer *timer = (PyGTimer *)head->next;
+
+	wheel_unlink(wheel, timer);
+	g_hash_table_remove(timer_ids, GUINT_TO_POINTER(timer->id));
+	link_append(dead, &timer->link);
+    }
+}
+
+/* Drops every timer of @wheel and releases their callbacks; must be called
+ * without the GIL. */
+static void
+wheel_clear(PyGTimerWheelSource *wheel)
+{
+    PyGTimerLink dead;
+    PyGILState_STATE state;
+    gint level, slot;
+
+    link_init(&dead);
+
+    G_LOCK(timer_wheel);
+    for (level = 0; level < WHEEL_LEVELS; level++)
+	for (slot = 0; slot < WHEEL_SLOTS; slot++)
+	    wheel_drain(wheel, &wheel->slots[level][slot], &dead);
+    wheel_drain(wheel, &wheel->expired, &dead);
+    if (wheel->running && !wheel->running->removed) {
+	/* freed by dispatch once the callback returns */
+	g_hash_table_remove(timer_ids, GUINT_TO_POINTER(wheel->running->id));
+	wheel->running->removed = TRUE;
+    }
+    wheel->n_pending = 0;
+    G_UNLOCK(timer_wheel);
+
+    if (link_is_empty(&dead))
+	return;
+
+    state = pyglib_gil_state_ensure();
+    while (!link_is_empty(&dead)) {
+	PyGTimer *timer = (PyGTimer *)dead.next;
+
+	link_remove(&timer->link);
+	timer_free(timer);
+    }
+    pyglib_gil_state_release(state);
+}
+
+static void
+pyg_timer_wheel_finalize(GSource *source)
+{
+    wheel_clear((PyGTimerWheelSource *)source);
+}
+
+static GSourceFuncs pyg_timer_wheel_funcs =
+{
+    pyg_timer_wheel_prepare,
+    pyg_timer_wheel_check,
+    pyg_timer_wheel_dispatch,
+    pyg_timer_wheel_finalize
+};
+
+/* glib.TimerWheel */
+
+PYGLIB_DEFINE_TYPE("glib.TimerWheel", PyGTimerWheel_Type, PyGSource)
+
+static PyObject *
+pyg_timer_wheel_repr(PyGSource *self)
+{
+    const char *desc;
+    guint pending = 0;
+
+    if (self->source) {
+	desc = g_source_get_context(self->source) ? "attached" : "unattached";
+	pending = ((PyGTimerWheelSource *)self->source)->n_pending;
+    } else {
+	desc = "destroyed";
+    }
+
+    return PYGLIB_PyUnicode_FromFormat("<%s glib timer wheel source with "
+				       "%u timers at 0x%lx>",
+				       desc, pending, (long)self);
+}
+
+static int
+pyg_timer_wheel_init(PyGSource *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "resolution", "slack", "priority", NULL };
+    guint resolution = 1, slack = 0;
+    gint priority = G_PRIORITY_DEFAULT;
+    PyGTimerWheelSource *wheel;
+    gint level, slot;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+				     "|IIi:glib.TimerWheel.__init__", kwlist,
+				     &resolution, &slack, &priority))
+	return -1;
+
+    if (self->source != NULL) {
+	PyErr_SetString(PyExc_RuntimeError,
+			"glib.TimerWheel is already initialized");
+	return -1;
+    }
+
+    if (resolution == 0) {
+	PyErr_SetString(PyExc_ValueError,
+			"resolution must be at least 1 millisecond");
+	return -1;
+    }
+
+    self->source = g_source_new(&pyg_timer_wheel_funcs,
+				sizeof(PyGTimerWheelSource));
+
+    wheel = (PyGTimerWheelSource *)self->source;
+    wheel->tick_usec = (guint64)resolution * 1000;
+    wheel->slack = (slack + resolution - 1) / resolution;
+    wheel->start = _pyglib_get_monotonic_time();
+    wheel->next_expiry = G_MAXUINT64;
+    for (level = 0; level < WHEEL_LEVELS; level++)
+	for (slot = 0; slot < WHEEL_SLOTS; slot++)
+	    link_init(&wheel->slots[level][slot]);
+    link_init(&wheel->expired);
+
+    if (priority != G_PRIORITY_DEFAULT)
+	g_source_set_priority(self->source, priority);
+
+    self->inst_dict = NULL;
+    self->weakreflist = NULL;
+
+    self->python_source = FALSE;
+
+    return 0;
+}
+
+static PyObject *
+pyg_timer_wheel_add_full(PyGSource *self, PyObject *args, guint64 scale,
+			 const char *format)
+{
+    PyObject *first, *callback, *cbargs = NULL, *data;
+    Py_ssize_t len;
+    guint interval, id;
+
+    CHECK_DESTROYED(self, NULL);
+
+    len = PyTuple_Size(args);
+    if (len < 2) {
+	PyErr_SetString(PyExc_TypeError,
+			"add requires at least 2 args");
+	return NULL;
+    }
+    first = PySequence_GetSlice(args, 0, 2);
+    if (!PyArg_ParseTuple(first, format, &interval, &callback)) {
+	Py_DECREF(first);
+	return NULL;
+    }
+    Py_DECREF(first);
+    if (!PyCallable_Check(callback)) {
+	PyErr_SetString(PyExc_TypeError, "second argument not callable");
+	return NULL;
+    }
+
+    cbargs = PySequence_GetSlice(args, 2, len);
+    if (cbargs == NULL)
+	return NULL;
+
+    data = Py_BuildValue("(ON)", callback, cbargs);
+    if (data == NULL)
+	return NULL;
+
+    id = wheel_add_timer((PyGTimerWheelSource *)self->source,
+			 (guint64)interval * scale, data);
+    return PYGLIB_PyLong_FromLong(id);
+}
+
+static PyObject *
+pyg_timer_wheel_add(PyGSource *self, PyObject *args)
+{
+    return pyg_timer_wheel_add_full(self, args, 1, "IO:add");
+}
+
+static PyObject *
+pyg_timer_wheel_add_seconds(PyGSource *self, PyObject *args)
+{
+    return pyg_timer_wheel_add_full(self, args, 1000, "IO:add_seconds");
+}
+
+static PyObject *
+pyg_timer_wheel_remove(PyGSource *self, PyObject *args)
+{
+    guint id;
+
+    if (!PyArg_ParseTuple(args, "I:remove", &id))
+	return NULL;
+
+    CHECK_DESTROYED(self, NULL);
+
+    return PyBool_FromLong(wheel_remove_id((PyGTimerWheelSource *)self->source,
+					   id));
+}
+
+static PyObject *
+pyg_timer_wheel_destroy(PyGSource *self)
+{
+    CHECK_DESTROYED(self, NULL);
+
+    /* glib.Source.destroy() keeps the GSource alive, so finalize would
+     * never get to release the pending timers */
+    pyglib_unblock_threads();
+    wheel_clear((PyGTimerWheelSource *)self->source);
+    pyglib_block_threads();
+
+    g_source_destroy(self->source);
+    g_source_unref(self->source);
+    self->source = NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static Py_ssize_t
+pyg_timer_wheel_length(PyGSource *self)
+{
+    CHECK_DESTROYED(self, -1);
+
+    return ((PyGTimerWheelSource *)self->source)->n_pending;
+}
+
+static PyMethodDef pyg_timer_wheel_methods[] = {
+    { "add", (PyCFunction)pyg_timer_wheel_add, METH_VARARGS },
+    { "add_seconds", (PyCFunction)pyg_timer_wheel_add_seconds, METH_VARARGS },
+    { "remove", (PyCFunction)pyg_timer_wheel_remove, METH_VARARGS },
+    { "destroy", (PyCFunction)pyg_timer_wheel_destroy, METH_NOARGS },
+    { NULL, NULL, 0 }
+};
+
+static PySequenceMethods pyg_timer_wheel_as_sequence = {
+    (lenfunc)pyg_timer_wheel_length,
+};
+
+void
+pyglib_timer_wheel_register_types(PyObject *d)
+{
+    timer_ids = g_hash_table_new(NULL, NULL);
+
+    PyGTimerWheel_Type.tp_repr = (reprfunc)pyg_timer_wheel_repr;
+    PyGTimerWheel_Type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+    PyGTimerWheel_Type.tp_base = (PyTypeObject *)&PyGSource_Type;
+    PyGTimerWheel_Type.tp_init = (initproc)pyg_timer_wheel_init;
+    PyGTimerWheel_Type.tp_methods = pyg_timer_wheel_methods;
+    PyGTimerWheel_Type.tp_as_sequence = &pyg_timer_wheel_as_sequence;
+    PYGLIB_REGISTER_TYPE(d, PyGTimerWheel_Type, "TimerWheel");
+}
@@ -1757,6 +1757,98 @@ pyg_threads_init (PyObject *unused, PyObject *args, PyObject *kwargs)
     return Py_None;
 }
 
+static PyObject *
+pyg_enable_deferred_unref(PyObject *unused, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "thread_safe", NULL };
+    PyObject *py_types = NULL, *seq;
+    GType *types;
+    Py_ssize_t i, n = 0;
+    gboolean ret;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:enable_deferred_unref",
+				     kwlist, &py_types))
+	return NULL;
+
+    if (py_types == NULL)
+	seq = PyTuple_New(0);
+    else
+	seq = PySequence_Fast(py_types, "thread_safe must be a sequence");
+    if (seq == NULL)
+	return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    types = g_new(GType, n + 1);
+    for (i = 0; i < n; i++) {
+	PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+
+	types[i] = pyg_type_from_object(item);
+	if (types[i] == 0 || !g_type_is_a(types[i], G_TYPE_OBJECT)) {
+	    if (!PyErr_Occurred())
+		PyErr_SetString(PyExc_TypeError,
+				"thread_safe must hold GObject types");
+	    g_free(types);
+	    Py_DECREF(seq);
+	    return NULL;
+	}
+    }
+    Py_DECREF(seq);
+
+    ret = pygobject_enable_deferred_unref(types, n);
+    g_free(types);
+    if (!ret)
+	return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_disable_deferred_unref(PyObject *unused)
+{
+    pygobject_disable_deferred_unref();
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_flush_deferred_unref(PyObject *unused)
+{
+    return PYGLIB_PyLong_FromLong(pygobject_flush_deferred_unref());
+}
+
+static PyObject *
+pyg_get_deferred_unref_stats(PyObject *unused)
+{
+    return pygobject_get_deferred_unref_stats();
+}
+
+static PyObject *
+pyg_enable_toggle_batching(PyObject *unused)
+{
+    if (!pygobject_enable_toggle_batching())
+	return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_disable_toggle_batching(PyObject *unused)
+{
+    pygobject_disable_toggle_batching();
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_get_toggle_batching_stats(PyObject *unused)
+{
+    return pygobject_get_toggle_batching_stats();
+}
+
 /* Only for backwards compatibility */
 int
 pygobject_enable_threads(void)
@@ -1953,6 +2045,20 @@ static PyMethodDef _gobject_functions[] = {
       (PyCFunction)pyg_object_new, METH_VARARGS|METH_KEYWORDS },
     { "threads_init",
       (PyCFunction)pyg_threads_init, METH_VARARGS|METH_KEYWORDS },
+    { "enable_deferred_unref",
+      (PyCFunction)pyg_enable_deferred_unref, METH_VARARGS|METH_KEYWORDS },
+    { "disable_deferred_unref",
+      (PyCFunction)pyg_disable_deferred_unref, METH_NOARGS },
+    { "flush_deferred_unref",
+      (PyCFunction)pyg_flush_deferred_unref, METH_NOARGS },
+    { "get_deferred_unref_stats",
+      (PyCFunction)pyg_get_deferred_unref_stats, METH_NOARGS },
+    { "enable_toggle_batching",
+      (PyCFunction)pyg_enable_toggle_batching, METH_NOARGS },
+    { "disable_toggle_batching",
+      (PyCFunction)pyg_disable_toggle_batching, METH_NOARGS },
+    { "get_toggle_batching_stats",
+      (PyCFunction)pyg_get_toggle_batching_stats, METH_NOARGS },
     { "signal_accumulator_true_handled",
       (PyCFunction)pyg_signal_accumulator_true_handled, METH_VARARGS },
     { "add_emission_hook",
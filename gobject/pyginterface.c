@@ -85,6 +85,7 @@ pyg_register_interface(PyObject *dict, const gchar *class_name,
     }
 
     g_type_set_qdata(gtype, pyginterface_type_key, type);
+    pygobject_invalidate_class_cache();
     
     PyDict_SetItemString(dict, (char *)class_name, (PyObject *)type);
     
@@ -163,11 +163,20 @@ PyObject *    pygobject_new_full         (GObject *obj, gboolean sink, gpointer
 PyObject *    pygobject_new_sunk         (GObject *obj);
 void          pygobject_sink             (GObject *obj);
 PyTypeObject *pygobject_lookup_class     (GType gtype);
+void          pygobject_invalidate_class_cache (void);
 void          pygobject_watch_closure    (PyObject *self, GClosure *closure);
 void          pygobject_register_sinkfunc(GType type,
 					  void (* sinkfunc)(GObject *object));
 int           pyg_type_register          (PyTypeObject *class,
 					  const gchar *type_name);
+gboolean      pygobject_enable_deferred_unref (GType *thread_types,
+					       guint n_thread_types);
+void          pygobject_disable_deferred_unref (void);
+guint         pygobject_flush_deferred_unref (void);
+PyObject *    pygobject_get_deferred_unref_stats (void);
+gboolean      pygobject_enable_toggle_batching (void);
+void          pygobject_disable_toggle_batching (void);
+PyObject *    pygobject_get_toggle_batching_stats (void);
 
 /* from pygboxed.c */
 extern PyTypeObject PyGBoxed_Type;
@@ -52,6 +52,13 @@ GQuark pygobject_has_updated_constructor_key;
 GQuark pygobject_instance_data_key;
 GQuark pygobject_ref_sunk_key;
 
+/* wrappers of the PyGObject layout share one free list, whatever their
+ * exact type: subclasses adding nothing to the instances are only
+ * distinguished by ob_type */
+static PyGLibFreeList *pygobject_freelist;
+#define PYGOBJECT_PLAIN_LAYOUT(tp) \
+    ((tp)->tp_basicsize == sizeof(PyGObject) && (tp)->tp_itemsize == 0)
+
 
 /* -------------- class <-> wrapper manipulation --------------- */
 
@@ -594,6 +601,7 @@ pygobject_register_class(PyObject *dict, const gchar *type_name,
 	/* stash a pointer to the python class with the GType */
 	Py_INCREF(type);
 	g_type_set_qdata(gtype, pygobject_class_key, type);
+	pygobject_invalidate_class_cache();
     }
 
     /* set up __doc__ descriptor on type */
@@ -603,13 +611,200 @@ pygobject_register_class(PyObject *dict, const gchar *type_name,
     PyDict_SetItemString(dict, (char *)class_name, (PyObject *)type);
 }
 
+/* -------------- batched toggle notifications ----------------- */
+
+/* Worker threads taking and dropping references to an object with a
+ * toggle-referenced wrapper notify a toggle every time the count goes
+ * from 1 to 2 and back, and each notification would take the GIL.  When
+ * batching is enabled, toggles notified by a thread not holding the GIL
+ * are pushed on a lock-free stack instead, and applied the next time
+ * the binding takes the GIL or from an idle source of the default main
+ * context.
+ *
+ * An "up" toggle keeps a reference to the object until it is applied:
+ * the object can neither be freed nor notify the matching "down" toggle
+ * before the wrapper took the reference the up toggle stands for. */
+
+typedef struct _PyGToggleNode PyGToggleNode;
+struct _PyGToggleNode {
+    PyGObject *self;
+    GObject *obj;
+    gboolean is_last_ref;
+    PyGToggleNode *next;
+};
+
+static volatile gint toggle_batching_enabled = 0;
+static gpointer toggle_queue = NULL;	/* PyGToggleNode */
+static volatile gint toggle_queue_length = 0;
+static volatile gint toggle_in_flight = 0;
+static volatile gint toggle_idle_pending = 0;
+/* with the GIL */
+static guint64 toggle_direct = 0;
+static guint64 toggle_applied = 0;
+static guint64 toggle_batches = 0;
+static guint toggle_max_batch = 0;
+
+static void
+toggle_queue_apply(PyGObject *dying)
+{
+    PyGToggleNode *list, *node, *next;
+    guint n = 0;
+
+    do {
+        list = g_atomic_pointer_get(&toggle_queue);
+    } while (list != NULL &&
+             !g_atomic_pointer_compare_and_exchange(&toggle_queue, list, NULL));
+    if (list == NULL)
+        return;
+
+    /* the references of the up toggles are taken before the down ones
+     * are dropped, so that no wrapper dies in the middle of the batch */
+    for (node = list; node != NULL; node = node->next) {
+        if (!node->is_last_ref && node->self != dying)
+            Py_INCREF(node->self);
+        n++;
+    }
+    for (node = list; node != NULL; node = node->next) {
+        if (node->is_last_ref && node->self != dying)
+            Py_DECREF(node->self);
+    }
+    for (node = list; node != NULL; node = next) {
+        next = node->next;
+        if (!node->is_last_ref)
+            g_object_unref(node->obj);
+        g_slice_free(PyGToggleNode, node);
+    }
+
+    g_atomic_int_add(&toggle_queue_length, -(gint)n);
+    toggle_applied += n;
+    toggle_batches++;
+    if (n > toggle_max_batch)
+        toggle_max_batch = n;
+}
+
+static void
+toggle_queue_apply_pending(void)
+{
+    if (g_atomic_pointer_get(&toggle_queue) != NULL)
+        toggle_queue_apply(NULL);
+}
+
+static gboolean
+toggle_queue_idle(gpointer user_data)
+{
+    PyGILState_STATE state;
+
+    g_atomic_int_set(&toggle_idle_pending, 0);
+    /* taking the GIL applies the queue */
+    state = pyglib_gil_state_ensure();
+    toggle_queue_apply_pending();
+    pyglib_gil_state_release(state);
+    return FALSE;
+}
+
+static void
+toggle_queue_push(PyGObject *self, GObject *obj, gboolean is_last_ref)
+{
+    PyGToggleNode *node;
+
+    node = g_slice_new(PyGToggleNode);
+    node->self = self;
+    node->obj = obj;
+    node->is_last_ref = is_last_ref;
+    if (!is_last_ref)
+        g_object_ref(obj);	/* 2 -> 3, no toggle */
+    do {
+        node->next = g_atomic_pointer_get(&toggle_queue);
+    } while (!g_atomic_pointer_compare_and_exchange(&toggle_queue,
+                                                    node->next, node));
+    g_atomic_int_inc(&toggle_queue_length);
+
+    if (g_atomic_int_compare_and_exchange(&toggle_idle_pending, 0, 1))
+        g_idle_add(toggle_queue_idle, NULL);
+}
+
+/* Called with the GIL once @self removed its toggle reference: waits for
+ * the toggles being queued by other threads, and drops the ones of
+ * @self, which must not be touched any more. */
+static void
+toggle_queue_forget(PyGObject *self)
+{
+    while (g_atomic_int_get(&toggle_in_flight) > 0)
+        g_thread_yield();
+    toggle_queue_apply(self);
+}
+
+/**
+ * pygobject_enable_toggle_batching:
+ *
+ * Makes the toggle notifications of threads not holding the GIL queued
+ * instead of taking it, see above.
+ *
+ * Returns: %FALSE with an exception set when the Python version cannot
+ * tell whether a thread holds the GIL
+ */
+gboolean
+pygobject_enable_toggle_batching(void)
+{
+#if PY_VERSION_HEX >= 0x03040000
+    if (!pyglib_enable_threads())
+        return FALSE;
+    _pyglib_set_gil_ensure_hook(toggle_queue_apply_pending);
+    g_atomic_int_set(&toggle_batching_enabled, 1);
+    return TRUE;
+#else
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "toggle batching needs Python 3.4 or newer");
+    return FALSE;
+#endif
+}
+
+void
+pygobject_disable_toggle_batching(void)
+{
+    g_atomic_int_set(&toggle_batching_enabled, 0);
+    _pyglib_set_gil_ensure_hook(NULL);
+    while (g_atomic_int_get(&toggle_in_flight) > 0)
+        g_thread_yield();
+    toggle_queue_apply_pending();
+}
+
+PyObject *
+pygobject_get_toggle_batching_stats(void)
+{
+    return Py_BuildValue("{s:N,s:i,s:K,s:K,s:K,s:I}",
+                         "enabled",
+                         PyBool_FromLong(g_atomic_int_get(&toggle_batching_enabled)),
+                         "queue_length",
+                         g_atomic_int_get(&toggle_queue_length),
+                         "direct", toggle_direct,
+                         "applied", toggle_applied,
+                         "batches", toggle_batches,
+                         "max_batch", toggle_max_batch);
+}
+
 static void
 pyg_toggle_notify (gpointer data, GObject *object, gboolean is_last_ref)
 {
     PyGObject *self = (PyGObject*) data;
     PyGILState_STATE state;
 
+#if PY_VERSION_HEX >= 0x03040000
+    if (g_atomic_int_get(&toggle_batching_enabled) && !PyGILState_Check()) {
+        g_atomic_int_inc(&toggle_in_flight);
+        /* disable_toggle_batching() may have applied the queue since */
+        if (g_atomic_int_get(&toggle_batching_enabled)) {
+            toggle_queue_push(self, object, is_last_ref);
+            g_atomic_int_add(&toggle_in_flight, -1);
+            return;
+        }
+        g_atomic_int_add(&toggle_in_flight, -1);
+    }
+#endif
+
     state = pyglib_gil_state_ensure();
+    toggle_queue_apply_pending();
+    toggle_direct++;
 
     if (is_last_ref)
 	Py_DECREF(self);
@@ -619,6 +814,19 @@ pyg_toggle_notify (gpointer data, GObject *object, gboolean is_last_ref)
     pyglib_gil_state_release(state);
 }
 
+  /* Wrappers without an inst_dict or watched closures hold no
+     references the cycle GC could follow, so pygobject_new_full()
+     leaves them untracked; this starts tracking them once one of
+     those is attached. */
+static inline void
+pygobject_track(PyGObject *self)
+{
+    if (self->private_flags.flags & PYGOBJECT_GC_UNTRACKED) {
+        self->private_flags.flags &= ~PYGOBJECT_GC_UNTRACKED;
+        PyObject_GC_Track((PyObject *) self);
+    }
+}
+
   /* Called when the inst_dict is first created; switches the 
      reference counting strategy to start using toggle ref to keep the
      wrapper alive while the GObject lives.  In contrast, while
@@ -901,6 +1109,55 @@ pygobject_find_slot_for(PyTypeObject *type, PyObject *bases, int slot_offset,
 #undef TYPE_SLOT
 }
 
+/* The class pygobject_lookup_class() resolved for a GType, kept in a
+ * single qdata slot.  Entries are only valid for the generation they
+ * were filled in: registering a class anywhere starts a new one. */
+typedef struct {
+    PyTypeObject *type;
+    guint generation;
+} PyGClassCacheEntry;
+
+static GQuark pygobject_resolved_class_key;
+static guint pygobject_class_generation = 1;
+
+/**
+ * pygobject_invalidate_class_cache:
+ *
+ * Forgets the wrapper classes resolved so far.  Called whenever the
+ * class registered for a GType, or the way to build one, may have
+ * changed.
+ */
+void
+pygobject_invalidate_class_cache(void)
+{
+    pygobject_class_generation++;
+}
+
+static PyTypeObject *
+pygobject_resolve_class(GType gtype)
+{
+    PyTypeObject *py_type;
+
+    py_type = pyg_type_get_custom(g_type_name(gtype));
+    if (py_type)
+	return py_type;
+
+    py_type = g_type_get_qdata(gtype, pygobject_class_key);
+    if (py_type == NULL) {
+	py_type = g_type_get_qdata(gtype, pyginterface_type_key);
+
+    if (py_type == NULL)
+        py_type = (PyTypeObject *)pygi_type_import_by_g_type(gtype);
+
+	if (py_type == NULL) {
+	    py_type = pygobject_new_with_interfaces(gtype);
+	    g_type_set_qdata(gtype, pyginterface_type_key, py_type);
+	}
+    }
+
+    return py_type;
+}
+
 /**
  * pygobject_lookup_class:
  * @gtype: the GType of the GObject subclass.
@@ -916,28 +1173,30 @@ pygobject_find_slot_for(PyTypeObject *type, PyObject *bases, int slot_offset,
 PyTypeObject *
 pygobject_lookup_class(GType gtype)
 {
+    PyGClassCacheEntry *entry;
     PyTypeObject *py_type;
 
     if (gtype == G_TYPE_INTERFACE)
 	return &PyGInterface_Type;
-    
-    py_type = pyg_type_get_custom(g_type_name(gtype));
-    if (py_type)
-	return py_type;
 
-    py_type = g_type_get_qdata(gtype, pygobject_class_key);
-    if (py_type == NULL) {
-	py_type = g_type_get_qdata(gtype, pyginterface_type_key);
+    entry = g_type_get_qdata(gtype, pygobject_resolved_class_key);
+    if (G_LIKELY(entry != NULL &&
+                 entry->generation == pygobject_class_generation))
+        return entry->type;
 
+    py_type = pygobject_resolve_class(gtype);
     if (py_type == NULL)
-        py_type = (PyTypeObject *)pygi_type_import_by_g_type(gtype);
+        return NULL;
 
-	if (py_type == NULL) {
-	    py_type = pygobject_new_with_interfaces(gtype);
-	    g_type_set_qdata(gtype, pyginterface_type_key, py_type);
-	}
+    if (entry == NULL) {
+        entry = g_new0(PyGClassCacheEntry, 1);
+        g_type_set_qdata(gtype, pygobject_resolved_class_key, entry);
     }
-    
+    Py_INCREF(py_type);
+    Py_XDECREF(entry->type);
+    entry->type = py_type;
+    entry->generation = pygobject_class_generation;
+
     return py_type;
 }
 
@@ -986,7 +1245,11 @@ pygobject_new_full(GObject *obj, gboolean sink, gpointer g_class)
            pygobject_new_with_interfaces(). fixes bug #141042 */
         if (tp->tp_flags & Py_TPFLAGS_HEAPTYPE)
             Py_INCREF(tp);
-	self = PyObject_GC_New(PyGObject, tp);
+	self = NULL;
+	if (PYGOBJECT_PLAIN_LAYOUT(tp))
+	    self = (PyGObject *)_pyglib_freelist_pop(pygobject_freelist, tp);
+	if (self == NULL)
+	    self = PyObject_GC_New(PyGObject, tp);
 	if (self == NULL)
 	    return NULL;
         self->inst_dict = NULL;
@@ -995,7 +1258,12 @@ pygobject_new_full(GObject *obj, gboolean sink, gpointer g_class)
 	self->obj = obj;
 	g_object_ref(obj);
 	pygobject_register_wrapper((PyObject *)self);
-	PyObject_GC_Track((PyObject *)self);
+	/* instances of subclasses with __slots__ may reference anything */
+	if ((inst_data == NULL || inst_data->closures == NULL) &&
+	    PYGOBJECT_PLAIN_LAYOUT(tp))
+	    self->private_flags.flags |= PYGOBJECT_GC_UNTRACKED;
+	else
+	    PyObject_GC_Track((PyObject *)self);
     }
 
     return (PyObject *)self;
@@ -1052,6 +1320,7 @@ pygobject_watch_closure(PyObject *self, GClosure *closure)
     g_return_if_fail(g_slist_find(data->closures, closure) == NULL);
     data->closures = g_slist_prepend(data->closures, closure);
     g_closure_add_invalidate_notifier(closure, data, pygobject_unwatch_closure);
+    pygobject_track(gself);
 }
 
 /* -------------- PyGObject behaviour ----------------- */
@@ -1076,7 +1345,9 @@ pygobject_dealloc(PyGObject *self)
     pygobject_clear(self);
     /* the following causes problems with subclassed types */
     /* Py_TYPE(self)->tp_free((PyObject *)self); */
-    PyObject_GC_Del(self);
+    if (!PYGOBJECT_PLAIN_LAYOUT(Py_TYPE(self)) ||
+        !_pyglib_freelist_push(pygobject_freelist, (PyObject *)self))
+        PyObject_GC_Del(self);
 }
 
 static PyObject*
@@ -1155,6 +1426,262 @@ pygobject_traverse(PyGObject *self, visitproc visit, void *arg)
     return ret;
 }
 
+/* -------------- deferred unref ----------------- */
+
+/* When enabled, wrappers dropping the last reference to a GObject do not
+ * unref it themselves: the object is pushed on a lock-free stack, and
+ * the stack is unreffed in one go later, without the GIL.  Objects of
+ * the types declared thread safe go to a finalizer thread, the other
+ * ones to an idle source of the default main context, so that they are
+ * finalized by the thread running the main loop. */
+
+typedef struct _PyGUnrefNode PyGUnrefNode;
+struct _PyGUnrefNode {
+    GObject *obj;
+    PyGUnrefNode *next;
+};
+
+typedef struct {
+    gpointer head;		/* PyGUnrefNode, pushed and taken atomically */
+    volatile gint length;
+    gint max_length;		/* with the GIL */
+} PyGUnrefQueue;
+
+static gboolean deferred_unref_enabled = FALSE;
+static GArray *deferred_unref_thread_types = NULL;
+static PyGUnrefQueue deferred_unref_idle_queue;
+static PyGUnrefQueue deferred_unref_thread_queue;
+static volatile gint deferred_unref_idle_pending = 0;
+static GMutex *deferred_unref_mutex = NULL;
+static GCond *deferred_unref_cond = NULL;
+static guint64 deferred_unref_queued = 0;	/* with the GIL */
+G_LOCK_DEFINE_STATIC(deferred_unref_stats);
+static guint64 deferred_unref_released = 0;
+static guint64 deferred_unref_batches = 0;
+
+static gboolean
+deferred_unref_push(PyGUnrefQueue *queue, GObject *obj)
+{
+    PyGUnrefNode *node;
+    gint length;
+
+    node = g_slice_new(PyGUnrefNode);
+    node->obj = obj;
+    do {
+        node->next = g_atomic_pointer_get(&queue->head);
+    } while (!g_atomic_pointer_compare_and_exchange(&queue->head,
+                                                    node->next, node));
+
+    g_atomic_int_inc(&queue->length);
+    length = g_atomic_int_get(&queue->length);
+    if (length > queue->max_length)
+        queue->max_length = length;
+
+    return node->next == NULL;
+}
+
+static guint
+deferred_unref_drain(PyGUnrefQueue *queue)
+{
+    PyGUnrefNode *node, *next;
+    guint n = 0;
+
+    do {
+        node = g_atomic_pointer_get(&queue->head);
+    } while (node != NULL &&
+             !g_atomic_pointer_compare_and_exchange(&queue->head, node, NULL));
+
+    for (; node != NULL; node = next) {
+        next = node->next;
+        g_object_unref(node->obj);
+        g_slice_free(PyGUnrefNode, node);
+        n++;
+    }
+
+    if (n > 0) {
+        g_atomic_int_add(&queue->length, -(gint)n);
+        G_LOCK(deferred_unref_stats);
+        deferred_unref_released += n;
+        deferred_unref_batches++;
+        G_UNLOCK(deferred_unref_stats);
+    }
+    return n;
+}
+
+static gboolean
+deferred_unref_idle(gpointer user_data)
+{
+    g_atomic_int_set(&deferred_unref_idle_pending, 0);
+    deferred_unref_drain(&deferred_unref_idle_queue);
+    return FALSE;
+}
+
+static gpointer
+deferred_unref_thread(gpointer data)
+{
+    for (;;) {
+        g_mutex_lock(deferred_unref_mutex);
+        while (g_atomic_pointer_get(&deferred_unref_thread_queue.head) == NULL)
+            g_cond_wait(deferred_unref_cond, deferred_unref_mutex);
+        g_mutex_unlock(deferred_unref_mutex);
+
+        deferred_unref_drain(&deferred_unref_thread_queue);
+    }
+    return NULL;
+}
+
+static gboolean
+deferred_unref_start_thread(void)
+{
+    if (deferred_unref_mutex != NULL)
+        return TRUE;
+
+    /* the finalizers of Python subclasses need the GIL */
+    if (!pyglib_enable_threads())
+        return FALSE;
+
+#if GLIB_CHECK_VERSION(2, 32, 0)
+    deferred_unref_mutex = g_new0(GMutex, 1);
+    g_mutex_init(deferred_unref_mutex);
+    deferred_unref_cond = g_new0(GCond, 1);
+    g_cond_init(deferred_unref_cond);
+    g_thread_unref(g_thread_new("pygobject-unref", deferred_unref_thread,
+                                NULL));
+#else
+    deferred_unref_mutex = g_mutex_new();
+    deferred_unref_cond = g_cond_new();
+    if (!g_thread_create(deferred_unref_thread, NULL, FALSE, NULL)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "could not start the finalizer thread");
+        return FALSE;
+    }
+#endif
+    return TRUE;
+}
+
+static gboolean
+deferred_unref_is_thread_safe(GType type)
+{
+    guint i;
+
+    if (deferred_unref_thread_types == NULL)
+        return FALSE;
+    for (i = 0; i < deferred_unref_thread_types->len; i++) {
+        if (g_type_is_a(type, g_array_index(deferred_unref_thread_types,
+                                            GType, i)))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Called with the GIL in place of g_object_unref(). */
+static gboolean
+pygobject_defer_unref(GObject *obj)
+{
+    if (G_LIKELY(!deferred_unref_enabled))
+        return FALSE;
+
+    if (deferred_unref_is_thread_safe(G_OBJECT_TYPE(obj))) {
+        if (deferred_unref_push(&deferred_unref_thread_queue, obj)) {
+            g_mutex_lock(deferred_unref_mutex);
+            g_cond_signal(deferred_unref_cond);
+            g_mutex_unlock(deferred_unref_mutex);
+        }
+    } else {
+        deferred_unref_push(&deferred_unref_idle_queue, obj);
+        if (g_atomic_int_compare_and_exchange(&deferred_unref_idle_pending,
+                                              0, 1))
+            g_idle_add(deferred_unref_idle, NULL);
+    }
+    deferred_unref_queued++;
+    return TRUE;
+}
+
+/**
+ * pygobject_enable_deferred_unref:
+ * @thread_types: the types whose instances can be finalized from any
+ * thread
+ * @n_thread_types: the length of @thread_types
+ *
+ * Makes wrappers queue the GObject reference they drop instead of
+ * releasing it, see above.
+ *
+ * Returns: %FALSE with an exception set when the finalizer thread could
+ * not be started
+ */
+gboolean
+pygobject_enable_deferred_unref(GType *thread_types, guint n_thread_types)
+{
+    if (n_thread_types > 0 && !deferred_unref_start_thread())
+        return FALSE;
+
+    if (deferred_unref_thread_types != NULL)
+        g_array_free(deferred_unref_thread_types, TRUE);
+    deferred_unref_thread_types = NULL;
+    if (n_thread_types > 0) {
+        deferred_unref_thread_types = g_array_sized_new(FALSE, FALSE,
+                                                        sizeof(GType),
+                                                        n_thread_types);
+        g_array_append_vals(deferred_unref_thread_types, thread_types,
+                            n_thread_types);
+    }
+
+    deferred_unref_enabled = TRUE;
+    return TRUE;
+}
+
+/**
+ * pygobject_flush_deferred_unref:
+ *
+ * Releases, in the calling thread, every reference queued so far.
+ *
+ * Returns: the number of references released
+ */
+guint
+pygobject_flush_deferred_unref(void)
+{
+    guint n;
+
+    pyg_begin_allow_threads;
+    n = deferred_unref_drain(&deferred_unref_idle_queue);
+    n += deferred_unref_drain(&deferred_unref_thread_queue);
+    pyg_end_allow_threads;
+
+    return n;
+}
+
+void
+pygobject_disable_deferred_unref(void)
+{
+    deferred_unref_enabled = FALSE;
+    pygobject_flush_deferred_unref();
+}
+
+PyObject *
+pygobject_get_deferred_unref_stats(void)
+{
+    guint64 released, batches;
+
+    G_LOCK(deferred_unref_stats);
+    released = deferred_unref_released;
+    batches = deferred_unref_batches;
+    G_UNLOCK(deferred_unref_stats);
+
+    return Py_BuildValue("{s:N,s:i,s:i,s:i,s:i,s:K,s:K,s:K}",
+                         "enabled", PyBool_FromLong(deferred_unref_enabled),
+                         "idle_queue_length",
+                         g_atomic_int_get(&deferred_unref_idle_queue.length),
+                         "max_idle_queue_length",
+                         deferred_unref_idle_queue.max_length,
+                         "thread_queue_length",
+                         g_atomic_int_get(&deferred_unref_thread_queue.length),
+                         "max_thread_queue_length",
+                         deferred_unref_thread_queue.max_length,
+                         "queued", deferred_unref_queued,
+                         "released", released,
+                         "batches", batches);
+}
+
 static inline int
 pygobject_clear(PyGObject *self)
 {
@@ -1163,7 +1690,10 @@ pygobject_clear(PyGObject *self)
         if (self->inst_dict) {
             g_object_remove_toggle_ref(self->obj, pyg_toggle_notify, self);
             self->private_flags.flags &= ~PYGOBJECT_USING_TOGGLE_REF;
-        } else {
+            if (g_atomic_pointer_get(&toggle_queue) != NULL ||
+                g_atomic_int_get(&toggle_in_flight) > 0)
+                toggle_queue_forget(self);
+        } else if (!pygobject_defer_unref(self->obj)) {
             pyg_begin_allow_threads;
             g_object_unref(self->obj);
             pyg_end_allow_threads;
@@ -2162,6 +2692,7 @@ pygobject_get_dict(PyGObject *self, void *closure)
 	self->inst_dict = PyDict_New();
 	if (self->inst_dict == NULL)
 	    return NULL;
+        pygobject_track(self);
         if (G_LIKELY(self->obj))
             pygobject_switch_to_toggle_ref(self);
     }
@@ -2184,6 +2715,7 @@ pygobject_setattro(PyObject *self, PyObject *name, PyObject *value)
       /* call parent type's setattro */
     res = PyGObject_Type.tp_base->tp_setattro(self, name, value);
     if (inst_dict_before == NULL && gself->inst_dict != NULL) {
+        pygobject_track(gself);
         if (G_LIKELY(gself->obj))
             pygobject_switch_to_toggle_ref(gself);
     }
@@ -2359,6 +2891,10 @@ pygobject_object_register_types(PyObject *d)
         g_quark_from_static_string("PyGObject::has-updated-constructor");
     pygobject_instance_data_key = g_quark_from_static_string("PyGObject::instance-data");
     pygobject_ref_sunk_key = g_quark_from_static_string("PyGObject::ref-sunk");
+    pygobject_resolved_class_key =
+        g_quark_from_static_string("PyGObject::resolved-class");
+    pygobject_freelist = _pyglib_freelist_new("gobject.GObject",
+                                              sizeof(PyGObject), TRUE);
 
     /* GObject */
     if (!PY_TYPE_OBJECT)
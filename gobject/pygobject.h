@@ -26,7 +26,8 @@ struct _PyGClosure {
 };
 
 typedef enum {
-    PYGOBJECT_USING_TOGGLE_REF = 1 << 0
+    PYGOBJECT_USING_TOGGLE_REF = 1 << 0,
+    PYGOBJECT_GC_UNTRACKED = 1 << 1
 } PyGObjectFlags;
 
   /* closures is just an alias for what is found in the
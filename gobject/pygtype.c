@@ -131,6 +131,7 @@ _wrap_g_type_wrapper__set_pytype(PyGTypeWrapper *self, PyObject* value, void *cl
 	PyErr_SetString(PyExc_TypeError, "Value must be None or a type object");
 	return -1;
     }
+    pygobject_invalidate_class_cache();
 
     return 0;
 }
@@ -634,6 +635,54 @@ pyg_type_lookup(GType type)
     return tm;
 }
 
+/* GValue conversions are resolved once per GType into a pair of
+ * converters, found through a flat table for the fundamental types and
+ * a hash table for the derived ones.  Types without any converter get
+ * an entry too, so unknown types are not looked up again.  Entries are
+ * filled in lazily and refilled once pyg_register_gtype_custom() moved
+ * the generation on. */
+
+typedef struct _PyGValueConverters PyGValueConverters;
+
+typedef int (* PyGValueFromFunc)(GValue *value, PyObject *obj,
+				 const PyGValueConverters *conv);
+typedef PyObject *(* PyGValueAsFunc)(const GValue *value,
+				     gboolean copy_boxed,
+				     const PyGValueConverters *conv);
+
+struct _PyGValueConverters {
+    PyGValueFromFunc from_pyobject;
+    PyGValueAsFunc as_pyobject;
+    PyGTypeMarshal *custom;
+    guint generation;
+};
+
+#define PYG_N_FUNDAMENTALS \
+    ((G_TYPE_FUNDAMENTAL_MAX >> G_TYPE_FUNDAMENTAL_SHIFT) + 1)
+
+static PyGValueConverters *pyg_value_fundamental_converters[PYG_N_FUNDAMENTALS];
+static GHashTable *pyg_value_converters = NULL;
+static guint pyg_value_converters_generation = 1;
+
+static PyGValueConverters *pyg_value_converters_fill(GType type,
+						     PyGValueConverters *conv);
+
+static inline const PyGValueConverters *
+pyg_value_converters_lookup(GType type)
+{
+    PyGValueConverters *conv = NULL;
+
+    if (type <= G_TYPE_FUNDAMENTAL_MAX)
+	conv = pyg_value_fundamental_converters[type >> G_TYPE_FUNDAMENTAL_SHIFT];
+    else if (pyg_value_converters != NULL)
+	conv = g_hash_table_lookup(pyg_value_converters, GSIZE_TO_POINTER(type));
+
+    if (G_LIKELY(conv != NULL &&
+		 conv->generation == pyg_value_converters_generation))
+	return conv;
+    return pyg_value_converters_fill(type, conv);
+}
+
 /**
  * pyg_register_gtype_custom:
  * @gtype: the GType for the new type
@@ -659,6 +708,9 @@ pyg_register_gtype_custom(GType gtype,
     tm->fromvalue = from_func;
     tm->tovalue = to_func;
     g_type_set_qdata(gtype, pyg_type_marshal_key, tm);
+
+    /* the handlers apply to the types derived from gtype too */
+    pyg_value_converters_generation++;
 }
 
 static int
@@ -727,281 +779,600 @@ pyg_value_array_from_pyobject(GValue *value,
     return 0;
 }
 
-/**
- * pyg_value_from_pyobject:
- * @value: the GValue object to store the converted value in.
- * @obj: the Python object to convert.
- *
- * This function converts a Python object and stores the result in a
- * GValue.  The GValue must be initialised in advance with
- * g_value_init().  If the Python object can't be converted to the
- * type of the GValue, then an error is returned.
- *
- * Returns: 0 on success, -1 on error.
- */
-int
-pyg_value_from_pyobject(GValue *value, PyObject *obj)
+/* -------------- GValue from Python ----------------- */
+
+static inline int
+pyg_value_from_check(GValue *value)
 {
-    PyObject *tmp;
+    if (PyErr_Occurred()) {
+        g_value_unset(value);
+        PyErr_Clear();
+        return -1;
+    }
+    return 0;
+}
 
-    switch (G_TYPE_FUNDAMENTAL(G_VALUE_TYPE(value))) {
-    case G_TYPE_INTERFACE:
-	/* we only handle interface types that have a GObject prereq */
-	if (g_type_is_a(G_VALUE_TYPE(value), G_TYPE_OBJECT)) {
-	    if (obj == Py_None)
-		g_value_set_object(value, NULL);
-	    else {
-		if (!PyObject_TypeCheck(obj, &PyGObject_Type)) {
-		    return -1;
-		}
-		if (!G_TYPE_CHECK_INSTANCE_TYPE(pygobject_get(obj),
-						G_VALUE_TYPE(value))) {
-		    return -1;
-		}
-		g_value_set_object(value, pygobject_get(obj));
-	    }
-	} else {
+static int
+pyg_value_from_interface(GValue *value, PyObject *obj,
+			 const PyGValueConverters *conv)
+{
+    /* we only handle interface types that have a GObject prereq */
+    if (obj == Py_None)
+	g_value_set_object(value, NULL);
+    else {
+	if (!PyObject_TypeCheck(obj, &PyGObject_Type)) {
 	    return -1;
 	}
-	break;
-    case G_TYPE_CHAR:
-#if PY_VERSION_HEX < 0x03000000
-	if (PyString_Check(obj)) {
-	    g_value_set_char(value, PyString_AsString(obj)[0]);
-	} else
-#endif
-	if (PyUnicode_Check(obj)) {
-	    tmp = PyUnicode_AsUTF8String(obj);
-	    g_value_set_char(value, PYGLIB_PyBytes_AsString(tmp)[0]);
-	    Py_DECREF(tmp);
-	} else {
-	    PyErr_Clear();
+	if (!G_TYPE_CHECK_INSTANCE_TYPE(pygobject_get(obj),
+					G_VALUE_TYPE(value))) {
 	    return -1;
 	}
+	g_value_set_object(value, pygobject_get(obj));
+    }
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_unsupported(GValue *value, PyObject *obj,
+			   const PyGValueConverters *conv)
+{
+    return -1;
+}
+
+static int
+pyg_value_from_char(GValue *value, PyObject *obj,
+		    const PyGValueConverters *conv)
+{
+    PyObject *tmp;
 
-	break;
-    case G_TYPE_UCHAR:
-	if (PYGLIB_PyLong_Check(obj)) {
-	    glong val;
-	    val = PYGLIB_PyLong_AsLong(obj);
-	    if (val >= 0 && val <= 255)
-	      g_value_set_uchar(value, (guchar)PYGLIB_PyLong_AsLong (obj));
-	    else
-	      return -1;
 #if PY_VERSION_HEX < 0x03000000
-	} else if (PyString_Check(obj)) {
-	    g_value_set_uchar(value, PyString_AsString(obj)[0]);
+    if (PyString_Check(obj)) {
+	g_value_set_char(value, PyString_AsString(obj)[0]);
+    } else
 #endif
-	} else if (PyUnicode_Check(obj)) {
-	    tmp = PyUnicode_AsUTF8String(obj);
-	    g_value_set_uchar(value, PYGLIB_PyBytes_AsString(tmp)[0]);
-	    Py_DECREF(tmp);
-	} else {
-	    PyErr_Clear();
+    if (PyUnicode_Check(obj)) {
+	tmp = PyUnicode_AsUTF8String(obj);
+	g_value_set_char(value, PYGLIB_PyBytes_AsString(tmp)[0]);
+	Py_DECREF(tmp);
+    } else {
+	PyErr_Clear();
+	return -1;
+    }
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_uchar(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    PyObject *tmp;
+
+    if (PYGLIB_PyLong_Check(obj)) {
+	glong val;
+	val = PYGLIB_PyLong_AsLong(obj);
+	if (val >= 0 && val <= 255)
+	  g_value_set_uchar(value, (guchar)PYGLIB_PyLong_AsLong (obj));
+	else
+	  return -1;
+#if PY_VERSION_HEX < 0x03000000
+    } else if (PyString_Check(obj)) {
+	g_value_set_uchar(value, PyString_AsString(obj)[0]);
+#endif
+    } else if (PyUnicode_Check(obj)) {
+	tmp = PyUnicode_AsUTF8String(obj);
+	g_value_set_uchar(value, PYGLIB_PyBytes_AsString(tmp)[0]);
+	Py_DECREF(tmp);
+    } else {
+	PyErr_Clear();
+	return -1;
+    }
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_boolean(GValue *value, PyObject *obj,
+		       const PyGValueConverters *conv)
+{
+    g_value_set_boolean(value, PyObject_IsTrue(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_int(GValue *value, PyObject *obj,
+		   const PyGValueConverters *conv)
+{
+    g_value_set_int(value, PYGLIB_PyLong_AsLong(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_uint(GValue *value, PyObject *obj,
+		    const PyGValueConverters *conv)
+{
+    if (PYGLIB_PyLong_Check(obj)) {
+	glong val;
+
+	val = PYGLIB_PyLong_AsLong(obj);
+	if (val >= 0 && val <= G_MAXUINT)
+	    g_value_set_uint(value, (guint)val);
+	else
 	    return -1;
-	}
-	break;
-    case G_TYPE_BOOLEAN:
-	g_value_set_boolean(value, PyObject_IsTrue(obj));
-	break;
-    case G_TYPE_INT:
-	g_value_set_int(value, PYGLIB_PyLong_AsLong(obj));
-	break;
-    case G_TYPE_UINT:
-	{
-	    if (PYGLIB_PyLong_Check(obj)) {
-		glong val;
-
-		val = PYGLIB_PyLong_AsLong(obj);
-		if (val >= 0 && val <= G_MAXUINT)
-		    g_value_set_uint(value, (guint)val);
-		else
-		    return -1;
-	    } else {
-		g_value_set_uint(value, PyLong_AsUnsignedLong(obj));
-	    }
-	}
-	break;
-    case G_TYPE_LONG:
-	g_value_set_long(value, PYGLIB_PyLong_AsLong(obj));
-	break;
-    case G_TYPE_ULONG:
+    } else {
+	g_value_set_uint(value, PyLong_AsUnsignedLong(obj));
+    }
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_long(GValue *value, PyObject *obj,
+		    const PyGValueConverters *conv)
+{
+    g_value_set_long(value, PYGLIB_PyLong_AsLong(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_ulong(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
 #if PY_VERSION_HEX < 0x03000000
-	if (PyInt_Check(obj)) {
-            long val;
+    if (PyInt_Check(obj)) {
+        long val;
 
-            val = PYGLIB_PyLong_AsLong(obj);
-            if (val < 0) {
-                PyErr_SetString(PyExc_OverflowError, "negative value not allowed for uint64 property");
-                return -1;
-            }
-            g_value_set_ulong(value, (gulong)val);
-        } else
-#endif
-        if (PyLong_Check(obj))
-	    g_value_set_ulong(value, PyLong_AsUnsignedLong(obj));
-        else
+        val = PYGLIB_PyLong_AsLong(obj);
+        if (val < 0) {
+            PyErr_SetString(PyExc_OverflowError, "negative value not allowed for uint64 property");
             return -1;
-        break;
-    case G_TYPE_INT64:
-	g_value_set_int64(value, PyLong_AsLongLong(obj));
-	break;
-    case G_TYPE_UINT64:
-#if PY_VERSION_HEX < 0x03000000
-        if (PyInt_Check(obj)) {
-            long v = PyInt_AsLong(obj);
-            if (v < 0) {
-                PyErr_SetString(PyExc_OverflowError, "negative value not allowed for uint64 property");
-                return -1;
-            }
-            g_value_set_uint64(value, v);
-        } else
+        }
+        g_value_set_ulong(value, (gulong)val);
+    } else
 #endif
-        if (PyLong_Check(obj))
-            g_value_set_uint64(value, PyLong_AsUnsignedLongLong(obj));
-        else
+    if (PyLong_Check(obj))
+	g_value_set_ulong(value, PyLong_AsUnsignedLong(obj));
+    else
+        return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_int64(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    g_value_set_int64(value, PyLong_AsLongLong(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_uint64(GValue *value, PyObject *obj,
+		      const PyGValueConverters *conv)
+{
+#if PY_VERSION_HEX < 0x03000000
+    if (PyInt_Check(obj)) {
+        long v = PyInt_AsLong(obj);
+        if (v < 0) {
+            PyErr_SetString(PyExc_OverflowError, "negative value not allowed for uint64 property");
             return -1;
-	break;
-    case G_TYPE_ENUM:
-	{
-	    gint val = 0;
-	    if (pyg_enum_get_value(G_VALUE_TYPE(value), obj, &val) < 0) {
-		PyErr_Clear();
-		return -1;
-	    }
-	    g_value_set_enum(value, val);
-	}
-	break;
-    case G_TYPE_FLAGS:
-	{
-	    gint val = 0;
-	    if (pyg_flags_get_value(G_VALUE_TYPE(value), obj, &val) < 0) {
-		PyErr_Clear();
+        }
+        g_value_set_uint64(value, v);
+    } else
+#endif
+    if (PyLong_Check(obj))
+        g_value_set_uint64(value, PyLong_AsUnsignedLongLong(obj));
+    else
+        return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_enum(GValue *value, PyObject *obj,
+		    const PyGValueConverters *conv)
+{
+    gint val = 0;
+
+    if (pyg_enum_get_value(G_VALUE_TYPE(value), obj, &val) < 0) {
+	PyErr_Clear();
+	return -1;
+    }
+    g_value_set_enum(value, val);
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_flags(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    gint val = 0;
+
+    if (pyg_flags_get_value(G_VALUE_TYPE(value), obj, &val) < 0) {
+	PyErr_Clear();
+	return -1;
+    }
+    g_value_set_flags(value, val);
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_float(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    g_value_set_float(value, PyFloat_AsDouble(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_double(GValue *value, PyObject *obj,
+		      const PyGValueConverters *conv)
+{
+    g_value_set_double(value, PyFloat_AsDouble(obj));
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_string(GValue *value, PyObject *obj,
+		      const PyGValueConverters *conv)
+{
+    PyObject *tmp;
+
+    if (obj == Py_None) {
+	g_value_set_string(value, NULL);
+    } else {
+	PyObject* tmp_str = PyObject_Str(obj);
+	if (tmp_str == NULL) {
+	    PyErr_Clear();
+	    if (PyUnicode_Check(obj)) {
+		tmp = PyUnicode_AsUTF8String(obj);
+		g_value_set_string(value, PYGLIB_PyBytes_AsString(tmp));
+		Py_DECREF(tmp);
+	    } else {
 		return -1;
 	    }
-	    g_value_set_flags(value, val);
-	}
-	break;
-    case G_TYPE_FLOAT:
-	g_value_set_float(value, PyFloat_AsDouble(obj));
-	break;
-    case G_TYPE_DOUBLE:
-	g_value_set_double(value, PyFloat_AsDouble(obj));
-	break;
-    case G_TYPE_STRING:
-	if (obj == Py_None) {
-	    g_value_set_string(value, NULL);
 	} else {
-	    PyObject* tmp_str = PyObject_Str(obj);
-	    if (tmp_str == NULL) {
-	        PyErr_Clear();
-	        if (PyUnicode_Check(obj)) {
-	            tmp = PyUnicode_AsUTF8String(obj);
-	            g_value_set_string(value, PYGLIB_PyBytes_AsString(tmp));
-	            Py_DECREF(tmp);
-	        } else {
-	            return -1;
-	        }
-	    } else {
 #if PY_VERSION_HEX < 0x03000000
-	       g_value_set_string(value, PyString_AsString(tmp_str));
+	   g_value_set_string(value, PyString_AsString(tmp_str));
 #else
-	       tmp = PyUnicode_AsUTF8String(tmp_str);
-	       g_value_set_string(value, PyBytes_AsString(tmp));
-	       Py_DECREF(tmp);
+	   tmp = PyUnicode_AsUTF8String(tmp_str);
+	   g_value_set_string(value, PyBytes_AsString(tmp));
+	   Py_DECREF(tmp);
 #endif
-	    }
-	    Py_XDECREF(tmp_str);
 	}
-	break;
-    case G_TYPE_POINTER:
-	if (obj == Py_None)
-	    g_value_set_pointer(value, NULL);
-	else if (PyObject_TypeCheck(obj, &PyGPointer_Type) &&
-		   G_VALUE_HOLDS(value, ((PyGPointer *)obj)->gtype))
-	    g_value_set_pointer(value, pyg_pointer_get(obj, gpointer));
-	else if (PYGLIB_CPointer_Check(obj))
-	    g_value_set_pointer(value, PYGLIB_CPointer_GetPointer(obj, NULL));
-	else
-	    return -1;
-	break;
-    case G_TYPE_BOXED: {
-	PyGTypeMarshal *bm;
-
-	if (obj == Py_None)
-	    g_value_set_boxed(value, NULL);
-	else if (G_VALUE_HOLDS(value, PY_TYPE_OBJECT))
-	    g_value_set_boxed(value, obj);
-	else if (PyObject_TypeCheck(obj, &PyGBoxed_Type) &&
-		   G_VALUE_HOLDS(value, ((PyGBoxed *)obj)->gtype))
-	    g_value_set_boxed(value, pyg_boxed_get(obj, gpointer));
-        else if (G_VALUE_HOLDS(value, G_TYPE_VALUE)) {
-            GType type;
-            GValue *n_value;
-
-            type = pyg_type_from_object((PyObject*)Py_TYPE(obj));
-            if (G_UNLIKELY (! type)) {
-                PyErr_Clear();
-                return -1;
-            }
-            n_value = g_new0 (GValue, 1);
-            g_value_init (n_value, type);
-            g_value_take_boxed (value, n_value);
-            return pyg_value_from_pyobject (n_value, obj);
-        }
-        else if (PySequence_Check(obj) &&
-		   G_VALUE_HOLDS(value, G_TYPE_VALUE_ARRAY))
-	    return pyg_value_array_from_pyobject(value, obj, NULL);
-	else if (PYGLIB_PyUnicode_Check(obj) &&
-                 G_VALUE_HOLDS(value, G_TYPE_GSTRING)) {
-            GString *string;
-            char *buffer;
-            Py_ssize_t len;
-            if (PYGLIB_PyUnicode_AsStringAndSize(obj, &buffer, &len))
-                return -1;
-            string = g_string_new_len(buffer, len);
-	    g_value_set_boxed(value, string);
-	    g_string_free (string, TRUE);
-            break;
+	Py_XDECREF(tmp_str);
+    }
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_pointer(GValue *value, PyObject *obj,
+		       const PyGValueConverters *conv)
+{
+    if (obj == Py_None)
+	g_value_set_pointer(value, NULL);
+    else if (PyObject_TypeCheck(obj, &PyGPointer_Type) &&
+	       G_VALUE_HOLDS(value, ((PyGPointer *)obj)->gtype))
+	g_value_set_pointer(value, pyg_pointer_get(obj, gpointer));
+    else if (PYGLIB_CPointer_Check(obj))
+	g_value_set_pointer(value, PYGLIB_CPointer_GetPointer(obj, NULL));
+    else
+	return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_boxed(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    if (obj == Py_None)
+	g_value_set_boxed(value, NULL);
+    else if (G_VALUE_HOLDS(value, PY_TYPE_OBJECT))
+	g_value_set_boxed(value, obj);
+    else if (PyObject_TypeCheck(obj, &PyGBoxed_Type) &&
+	       G_VALUE_HOLDS(value, ((PyGBoxed *)obj)->gtype))
+	g_value_set_boxed(value, pyg_boxed_get(obj, gpointer));
+    else if (G_VALUE_HOLDS(value, G_TYPE_VALUE)) {
+        GType type;
+        GValue *n_value;
+
+        type = pyg_type_from_object((PyObject*)Py_TYPE(obj));
+        if (G_UNLIKELY (! type)) {
+            PyErr_Clear();
+            return -1;
         }
-	else if ((bm = pyg_type_lookup(G_VALUE_TYPE(value))) != NULL)
-	    return bm->tovalue(value, obj);
-	else if (PYGLIB_CPointer_Check(obj))
-	    g_value_set_boxed(value, PYGLIB_CPointer_GetPointer(obj, NULL));
-	else
-	    return -1;
-	break;
+        n_value = g_new0 (GValue, 1);
+        g_value_init (n_value, type);
+        g_value_take_boxed (value, n_value);
+        return pyg_value_from_pyobject (n_value, obj);
     }
-    case G_TYPE_PARAM:
-	if (PyGParamSpec_Check(obj))
-	    g_value_set_param(value, PYGLIB_CPointer_GetPointer(obj, NULL));
-	else
-	    return -1;
-	break;
-    case G_TYPE_OBJECT:
-	if (obj == Py_None) {
-	    g_value_set_object(value, NULL);
-	} else if (PyObject_TypeCheck(obj, &PyGObject_Type) &&
-		   G_TYPE_CHECK_INSTANCE_TYPE(pygobject_get(obj),
-					      G_VALUE_TYPE(value))) {
-	    g_value_set_object(value, pygobject_get(obj));
-	} else
-	    return -1;
-	break;
-    default:
-	{
-	    PyGTypeMarshal *bm;
-	    if ((bm = pyg_type_lookup(G_VALUE_TYPE(value))) != NULL)
-		return bm->tovalue(value, obj);
-	    break;
+    else if (PySequence_Check(obj) &&
+	       G_VALUE_HOLDS(value, G_TYPE_VALUE_ARRAY))
+	return pyg_value_array_from_pyobject(value, obj, NULL);
+    else if (PYGLIB_PyUnicode_Check(obj) &&
+             G_VALUE_HOLDS(value, G_TYPE_GSTRING)) {
+        GString *string;
+        char *buffer;
+        Py_ssize_t len;
+        if (PYGLIB_PyUnicode_AsStringAndSize(obj, &buffer, &len))
+            return -1;
+        string = g_string_new_len(buffer, len);
+	g_value_set_boxed(value, string);
+	g_string_free (string, TRUE);
+    }
+    else if (conv->custom != NULL)
+	return conv->custom->tovalue(value, obj);
+    else if (PYGLIB_CPointer_Check(obj))
+	g_value_set_boxed(value, PYGLIB_CPointer_GetPointer(obj, NULL));
+    else
+	return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_param(GValue *value, PyObject *obj,
+		     const PyGValueConverters *conv)
+{
+    if (PyGParamSpec_Check(obj))
+	g_value_set_param(value, PYGLIB_CPointer_GetPointer(obj, NULL));
+    else
+	return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_object(GValue *value, PyObject *obj,
+		      const PyGValueConverters *conv)
+{
+    if (obj == Py_None) {
+	g_value_set_object(value, NULL);
+    } else if (PyObject_TypeCheck(obj, &PyGObject_Type) &&
+	       G_TYPE_CHECK_INSTANCE_TYPE(pygobject_get(obj),
+					  G_VALUE_TYPE(value))) {
+	g_value_set_object(value, pygobject_get(obj));
+    } else
+	return -1;
+    return pyg_value_from_check(value);
+}
+
+static int
+pyg_value_from_custom(GValue *value, PyObject *obj,
+		      const PyGValueConverters *conv)
+{
+    return conv->custom->tovalue(value, obj);
+}
+
+static int
+pyg_value_from_unknown(GValue *value, PyObject *obj,
+		       const PyGValueConverters *conv)
+{
+    return pyg_value_from_check(value);
+}
+
+/**
+ * pyg_value_from_pyobject:
+ * @value: the GValue object to store the converted value in.
+ * @obj: the Python object to convert.
+ *
+ * This function converts a Python object and stores the result in a
+ * GValue.  The GValue must be initialised in advance with
+ * g_value_init().  If the Python object can't be converted to the
+ * type of the GValue, then an error is returned.
+ *
+ * Returns: 0 on success, -1 on error.
+ */
+int
+pyg_value_from_pyobject(GValue *value, PyObject *obj)
+{
+    const PyGValueConverters *conv;
+
+    conv = pyg_value_converters_lookup(G_VALUE_TYPE(value));
+    return conv->from_pyobject(value, obj, conv);
+}
+
+/* -------------- GValue to Python ----------------- */
+
+static PyObject *
+pyg_value_as_object(const GValue *value, gboolean copy_boxed,
+		    const PyGValueConverters *conv)
+{
+    return pygobject_new_sunk(g_value_get_object(value));
+}
+
+static PyObject *
+pyg_value_as_char(const GValue *value, gboolean copy_boxed,
+		  const PyGValueConverters *conv)
+{
+    gint8 val = g_value_get_char(value);
+    return PYGLIB_PyUnicode_FromStringAndSize((char *)&val, 1);
+}
+
+static PyObject *
+pyg_value_as_uchar(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    guint8 val = g_value_get_uchar(value);
+    return PYGLIB_PyBytes_FromStringAndSize((char *)&val, 1);
+}
+
+static PyObject *
+pyg_value_as_boolean(const GValue *value, gboolean copy_boxed,
+		     const PyGValueConverters *conv)
+{
+    return PyBool_FromLong(g_value_get_boolean(value));
+}
+
+static PyObject *
+pyg_value_as_int(const GValue *value, gboolean copy_boxed,
+		 const PyGValueConverters *conv)
+{
+    return PYGLIB_PyLong_FromLong(g_value_get_int(value));
+}
+
+static PyObject *
+pyg_value_as_uint(const GValue *value, gboolean copy_boxed,
+		  const PyGValueConverters *conv)
+{
+    /* in Python, the Int object is backed by a long.  If a
+       long can hold the whole value of an unsigned int, use
+       an Int.  Otherwise, use a Long object to avoid overflow.
+       This matches the ULongArg behavior in codegen/argtypes.h */
+#if (G_MAXUINT <= G_MAXLONG)
+    return PYGLIB_PyLong_FromLong((glong) g_value_get_uint(value));
+#else
+    return PyLong_FromUnsignedLong((gulong) g_value_get_uint(value));
+#endif
+}
+
+static PyObject *
+pyg_value_as_long(const GValue *value, gboolean copy_boxed,
+		  const PyGValueConverters *conv)
+{
+    return PYGLIB_PyLong_FromLong(g_value_get_long(value));
+}
+
+static PyObject *
+pyg_value_as_ulong(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    gulong val = g_value_get_ulong(value);
+
+    if (val <= G_MAXLONG)
+	return PYGLIB_PyLong_FromLong((glong) val);
+    else
+	return PyLong_FromUnsignedLong(val);
+}
+
+static PyObject *
+pyg_value_as_int64(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    gint64 val = g_value_get_int64(value);
+
+    if (G_MINLONG <= val && val <= G_MAXLONG)
+	return PYGLIB_PyLong_FromLong((glong) val);
+    else
+	return PyLong_FromLongLong(val);
+}
+
+static PyObject *
+pyg_value_as_uint64(const GValue *value, gboolean copy_boxed,
+		    const PyGValueConverters *conv)
+{
+    guint64 val = g_value_get_uint64(value);
+
+    if (val <= G_MAXLONG)
+	return PYGLIB_PyLong_FromLong((glong) val);
+    else
+	return PyLong_FromUnsignedLongLong(val);
+}
+
+static PyObject *
+pyg_value_as_enum(const GValue *value, gboolean copy_boxed,
+		  const PyGValueConverters *conv)
+{
+    return pyg_enum_from_gtype(G_VALUE_TYPE(value), g_value_get_enum(value));
+}
+
+static PyObject *
+pyg_value_as_flags(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    return pyg_flags_from_gtype(G_VALUE_TYPE(value), g_value_get_flags(value));
+}
+
+static PyObject *
+pyg_value_as_float(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    return PyFloat_FromDouble(g_value_get_float(value));
+}
+
+static PyObject *
+pyg_value_as_double(const GValue *value, gboolean copy_boxed,
+		    const PyGValueConverters *conv)
+{
+    return PyFloat_FromDouble(g_value_get_double(value));
+}
+
+static PyObject *
+pyg_value_as_string(const GValue *value, gboolean copy_boxed,
+		    const PyGValueConverters *conv)
+{
+    const gchar *str = g_value_get_string(value);
+
+    if (str)
+	return PYGLIB_PyUnicode_FromString(str);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+pyg_value_as_pointer(const GValue *value, gboolean copy_boxed,
+		     const PyGValueConverters *conv)
+{
+    return pyg_pointer_new(G_VALUE_TYPE(value),
+			   g_value_get_pointer(value));
+}
+
+static PyObject *
+pyg_value_as_boxed(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    if (G_VALUE_HOLDS(value, PY_TYPE_OBJECT)) {
+	PyObject *ret = (PyObject *)g_value_dup_boxed(value);
+	if (ret == NULL) {
+	    Py_INCREF(Py_None);
+	    return Py_None;
 	}
+	return ret;
+    } else if (G_VALUE_HOLDS(value, G_TYPE_VALUE)) {
+        GValue *n_value = g_value_get_boxed (value);
+        return pyg_value_as_pyobject(n_value, copy_boxed);
+    } else if (G_VALUE_HOLDS(value, G_TYPE_VALUE_ARRAY)) {
+	GValueArray *array = (GValueArray *) g_value_get_boxed(value);
+	PyObject *ret = PyList_New(array->n_values);
+	int i;
+	for (i = 0; i < array->n_values; ++i)
+	    PyList_SET_ITEM(ret, i, pyg_value_as_pyobject
+                            (array->values + i, copy_boxed));
+	return ret;
+    } else if (G_VALUE_HOLDS(value, G_TYPE_GSTRING)) {
+	GString *string = (GString *) g_value_get_boxed(value);
+	PyObject *ret = PYGLIB_PyUnicode_FromStringAndSize(string->str, string->len);
+	return ret;
     }
-    if (PyErr_Occurred()) {
-        g_value_unset(value);
-        PyErr_Clear();
-        return -1;
+    if (conv->custom) {
+	return conv->custom->fromvalue(value);
+    } else {
+	if (copy_boxed)
+	    return pyg_boxed_new(G_VALUE_TYPE(value),
+				 g_value_get_boxed(value), TRUE, TRUE);
+	else
+	    return pyg_boxed_new(G_VALUE_TYPE(value),
+				 g_value_get_boxed(value),FALSE,FALSE);
     }
-    return 0;
+}
+
+static PyObject *
+pyg_value_as_param(const GValue *value, gboolean copy_boxed,
+		   const PyGValueConverters *conv)
+{
+    return pyg_param_spec_new(g_value_get_param(value));
+}
+
+static PyObject *
+pyg_value_as_custom(const GValue *value, gboolean copy_boxed,
+		    const PyGValueConverters *conv)
+{
+    return conv->custom->fromvalue(value);
+}
+
+static PyObject *
+pyg_value_as_unknown(const GValue *value, gboolean copy_boxed,
+		     const PyGValueConverters *conv)
+{
+    gchar buf[128];
+
+    g_snprintf(buf, sizeof(buf), "unknown type %s",
+	       g_type_name(G_VALUE_TYPE(value)));
+    PyErr_SetString(PyExc_TypeError, buf);
+    return NULL;
 }
 
 /**
@@ -1017,142 +1388,87 @@ pyg_value_from_pyobject(GValue *value, PyObject *obj)
 PyObject *
 pyg_value_as_pyobject(const GValue *value, gboolean copy_boxed)
 {
-    gchar buf[128];
+    const PyGValueConverters *conv;
+
+    conv = pyg_value_converters_lookup(G_VALUE_TYPE(value));
+    return conv->as_pyobject(value, copy_boxed, conv);
+}
+
+static PyGValueConverters *
+pyg_value_converters_fill(GType type, PyGValueConverters *conv)
+{
+    PyGValueFromFunc from_pyobject;
+    PyGValueAsFunc as_pyobject;
+    PyGTypeMarshal *custom = NULL;
 
-    switch (G_TYPE_FUNDAMENTAL(G_VALUE_TYPE(value))) {
+    switch (G_TYPE_FUNDAMENTAL(type)) {
     case G_TYPE_INTERFACE:
-	if (g_type_is_a(G_VALUE_TYPE(value), G_TYPE_OBJECT))
-	    return pygobject_new_sunk(g_value_get_object(value));
-	else
-	    break;
-    case G_TYPE_CHAR: {
-	gint8 val = g_value_get_char(value);
-	return PYGLIB_PyUnicode_FromStringAndSize((char *)&val, 1);
-    }
-    case G_TYPE_UCHAR: {
-	guint8 val = g_value_get_uchar(value);
-	return PYGLIB_PyBytes_FromStringAndSize((char *)&val, 1);
-    }
-    case G_TYPE_BOOLEAN: {
-	return PyBool_FromLong(g_value_get_boolean(value));
-    }
-    case G_TYPE_INT:
-	return PYGLIB_PyLong_FromLong(g_value_get_int(value));
-    case G_TYPE_UINT:
-	{
-	    /* in Python, the Int object is backed by a long.  If a
-	       long can hold the whole value of an unsigned int, use
-	       an Int.  Otherwise, use a Long object to avoid overflow.
-	       This matches the ULongArg behavior in codegen/argtypes.h */
-#if (G_MAXUINT <= G_MAXLONG)
-	    return PYGLIB_PyLong_FromLong((glong) g_value_get_uint(value));
-#else
-	    return PyLong_FromUnsignedLong((gulong) g_value_get_uint(value));
-#endif
-	}
-    case G_TYPE_LONG:
-	return PYGLIB_PyLong_FromLong(g_value_get_long(value));
-    case G_TYPE_ULONG:
-	{
-	    gulong val = g_value_get_ulong(value);
-
-	    if (val <= G_MAXLONG)
-		return PYGLIB_PyLong_FromLong((glong) val);
-	    else
-		return PyLong_FromUnsignedLong(val);
-	}
-    case G_TYPE_INT64:
-	{
-	    gint64 val = g_value_get_int64(value);
-
-	    if (G_MINLONG <= val && val <= G_MAXLONG)
-		return PYGLIB_PyLong_FromLong((glong) val);
-	    else
-		return PyLong_FromLongLong(val);
-	}
-    case G_TYPE_UINT64:
-	{
-	    guint64 val = g_value_get_uint64(value);
-
-	    if (val <= G_MAXLONG)
-		return PYGLIB_PyLong_FromLong((glong) val);
-	    else
-		return PyLong_FromUnsignedLongLong(val);
-	}
-    case G_TYPE_ENUM:
-	return pyg_enum_from_gtype(G_VALUE_TYPE(value), g_value_get_enum(value));
-    case G_TYPE_FLAGS:
-	return pyg_flags_from_gtype(G_VALUE_TYPE(value), g_value_get_flags(value));
-    case G_TYPE_FLOAT:
-	return PyFloat_FromDouble(g_value_get_float(value));
-    case G_TYPE_DOUBLE:
-	return PyFloat_FromDouble(g_value_get_double(value));
-    case G_TYPE_STRING:
-	{
-	    const gchar *str = g_value_get_string(value);
-
-	    if (str)
-		return PYGLIB_PyUnicode_FromString(str);
-	    Py_INCREF(Py_None);
-	    return Py_None;
-	}
-    case G_TYPE_POINTER:
-	return pyg_pointer_new(G_VALUE_TYPE(value),
-			       g_value_get_pointer(value));
-    case G_TYPE_BOXED: {
-	PyGTypeMarshal *bm;
-
-	if (G_VALUE_HOLDS(value, PY_TYPE_OBJECT)) {
-	    PyObject *ret = (PyObject *)g_value_dup_boxed(value);
-	    if (ret == NULL) {
-		Py_INCREF(Py_None);
-		return Py_None;
-	    }
-	    return ret;
-        } else if (G_VALUE_HOLDS(value, G_TYPE_VALUE)) {
-            GValue *n_value = g_value_get_boxed (value);
-            return pyg_value_as_pyobject(n_value, copy_boxed);
-        } else if (G_VALUE_HOLDS(value, G_TYPE_VALUE_ARRAY)) {
-	    GValueArray *array = (GValueArray *) g_value_get_boxed(value);
-	    PyObject *ret = PyList_New(array->n_values);
-	    int i;
-	    for (i = 0; i < array->n_values; ++i)
-		PyList_SET_ITEM(ret, i, pyg_value_as_pyobject
-                                (array->values + i, copy_boxed));
-	    return ret;
-	} else if (G_VALUE_HOLDS(value, G_TYPE_GSTRING)) {
-	    GString *string = (GString *) g_value_get_boxed(value);
-	    PyObject *ret = PYGLIB_PyUnicode_FromStringAndSize(string->str, string->len);
-	    return ret;
+	if (g_type_is_a(type, G_TYPE_OBJECT)) {
+	    from_pyobject = pyg_value_from_interface;
+	    as_pyobject = pyg_value_as_object;
+	} else {
+	    from_pyobject = pyg_value_from_unsupported;
+	    as_pyobject = pyg_value_as_unknown;
 	}
-	bm = pyg_type_lookup(G_VALUE_TYPE(value));
-	if (bm) {
-	    return bm->fromvalue(value);
+	break;
+#define CONVERTERS(fundamental, name)			\
+    case fundamental:					\
+	from_pyobject = pyg_value_from_##name;		\
+	as_pyobject = pyg_value_as_##name;		\
+	break
+    CONVERTERS(G_TYPE_CHAR, char);
+    CONVERTERS(G_TYPE_UCHAR, uchar);
+    CONVERTERS(G_TYPE_BOOLEAN, boolean);
+    CONVERTERS(G_TYPE_INT, int);
+    CONVERTERS(G_TYPE_UINT, uint);
+    CONVERTERS(G_TYPE_LONG, long);
+    CONVERTERS(G_TYPE_ULONG, ulong);
+    CONVERTERS(G_TYPE_INT64, int64);
+    CONVERTERS(G_TYPE_UINT64, uint64);
+    CONVERTERS(G_TYPE_ENUM, enum);
+    CONVERTERS(G_TYPE_FLAGS, flags);
+    CONVERTERS(G_TYPE_FLOAT, float);
+    CONVERTERS(G_TYPE_DOUBLE, double);
+    CONVERTERS(G_TYPE_STRING, string);
+    CONVERTERS(G_TYPE_POINTER, pointer);
+    CONVERTERS(G_TYPE_PARAM, param);
+    CONVERTERS(G_TYPE_OBJECT, object);
+#undef CONVERTERS
+    case G_TYPE_BOXED:
+	from_pyobject = pyg_value_from_boxed;
+	as_pyobject = pyg_value_as_boxed;
+	custom = pyg_type_lookup(type);
+	break;
+    default:
+	custom = pyg_type_lookup(type);
+	if (custom != NULL) {
+	    from_pyobject = pyg_value_from_custom;
+	    as_pyobject = pyg_value_as_custom;
 	} else {
-	    if (copy_boxed)
-		return pyg_boxed_new(G_VALUE_TYPE(value),
-				     g_value_get_boxed(value), TRUE, TRUE);
-	    else
-		return pyg_boxed_new(G_VALUE_TYPE(value),
-				     g_value_get_boxed(value),FALSE,FALSE);
+	    from_pyobject = pyg_value_from_unknown;
+	    as_pyobject = pyg_value_as_unknown;
 	}
+	break;
     }
-    case G_TYPE_PARAM:
-	return pyg_param_spec_new(g_value_get_param(value));
-    case G_TYPE_OBJECT:
-	return pygobject_new_sunk(g_value_get_object(value));
-    default:
-	{
-	    PyGTypeMarshal *bm;
-	    if ((bm = pyg_type_lookup(G_VALUE_TYPE(value))))
-		return bm->fromvalue(value);
-	    break;
+
+    if (conv == NULL) {
+	conv = g_new(PyGValueConverters, 1);
+	if (type <= G_TYPE_FUNDAMENTAL_MAX)
+	    pyg_value_fundamental_converters[type >> G_TYPE_FUNDAMENTAL_SHIFT] = conv;
+	else {
+	    if (pyg_value_converters == NULL)
+		pyg_value_converters = g_hash_table_new(g_direct_hash,
+							g_direct_equal);
+	    g_hash_table_insert(pyg_value_converters,
+				GSIZE_TO_POINTER(type), conv);
 	}
     }
-    g_snprintf(buf, sizeof(buf), "unknown type %s",
-	       g_type_name(G_VALUE_TYPE(value)));
-    PyErr_SetString(PyExc_TypeError, buf);
-    return NULL;
+    conv->from_pyobject = from_pyobject;
+    conv->as_pyobject = as_pyobject;
+    conv->custom = custom;
+    conv->generation = pyg_value_converters_generation;
+
+    return conv;
 }
 
 /* -------------- PyGClosure ----------------- */
@@ -1745,6 +2061,7 @@ pyg_type_register_custom_callback(const gchar *typename,
     g_hash_table_insert(custom_type_registration,
 			g_strdup(typename),
 			data);
+    pygobject_invalidate_class_cache();
 }
 
 PyTypeObject *
@@ -79,6 +79,7 @@ glib = Extension(name='glib._glib',
                  include_dirs=['glib'],
                  libraries=['pyglib', 'glib-2.0', 'gthread-2.0'],
                  sources=['glib/glibmodule.c',
+                          'glib/pygeventloop.c',
                           'glib/pygiochannel.c',
                           'glib/pygmaincontext.c',
                           'glib/pygmainloop.c',
@@ -86,6 +87,7 @@ glib = Extension(name='glib._glib',
                           'glib/pygoptiongroup.c',
                           'glib/pygsource.c',
                           'glib/pygspawn.c',
+                          'glib/pygtimerwheel.c',
                           ])
 
 # GObject
@@ -145,6 +147,7 @@ gio = GioExtension(name='gio._gio',
                    libraries=['pyglib', 'glib-2.0', 'gio-2.0', 'gobject-2.0'],
                    sources=['gio/giomodule.c',
                             'gio/gio.c',
+                            'gio/pygio-future.c',
                             'gio/pygio-utils.c'],
                    defs='gio/gio.defs',
                    register=['gio/gio-types.defs'],
@@ -0,0 +1,82 @@
+# -*- Mode: Python -*-
+#
+# Walks a large flat directory on tmpfs with gio.FileEnumerator, one
+# next_file() call per entry versus batched iteration, while another
+# Python thread counts how often it gets to run.  Run from the build
+# tree:
+#
+#   PYTHONPATH=.. python bench_fileenumerator.py [entries] [directory]
+
+import os
+import shutil
+import sys
+import tempfile
+import threading
+import time
+
+import gio
+
+
+class Ticker(threading.Thread):
+    def __init__(self):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.ticks = 0
+        self.running = True
+
+    def run(self):
+        while self.running:
+            self.ticks += 1
+            time.sleep(0)
+
+
+def populate(path, entries):
+    for i in range(entries):
+        open(os.path.join(path, '%07d' % i), 'w').close()
+
+
+def walk(path, kind):
+    enumerator = gio.File(path).enumerate_children('standard::name')
+    count = 0
+    if kind == 'next_file':
+        while enumerator.next_file() is not None:
+            count += 1
+    elif kind == 'iterate':
+        for info in enumerator:
+            count += 1
+    else:
+        while True:
+            batch = enumerator.next_files(1000)
+            if not batch:
+                break
+            count += len(batch)
+    return count
+
+
+def main(entries, parent):
+    path = tempfile.mkdtemp(dir=parent)
+    try:
+        start = time.time()
+        populate(path, entries)
+        print('created %d entries in %s in %.1fs' % (entries, path,
+                                                     time.time() - start))
+
+        print('%-12s %12s %14s' % ('kind', 'entries/s', 'thread ticks'))
+        for kind in ('next_file', 'iterate', 'next_files'):
+            ticker = Ticker()
+            ticker.start()
+            start = time.time()
+            count = walk(path, kind)
+            elapsed = time.time() - start
+            ticker.running = False
+            ticker.join()
+            assert count == entries
+            print('%-12s %12.0f %14d' % (kind, count / elapsed, ticker.ticks))
+    finally:
+        shutil.rmtree(path)
+
+
+if __name__ == '__main__':
+    entries = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+    parent = sys.argv[2] if len(sys.argv) > 2 else '/dev/shm'
+    main(entries, parent)
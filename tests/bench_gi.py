@@ -0,0 +1,482 @@
+# -*- Mode: Python -*-
+#
+# Measures the overhead of the introspection binding layer against the
+# GIMarshallingTests and Regress typelibs built for the tests.  Run from
+# the build tree with
+#
+#   make -C tests bench BENCH_FLAGS="--json after.json --baseline before.json"
+#
+# or with the environment "make check" sets up:
+#
+#   PYTHONPATH=..:. GI_TYPELIB_PATH=. LD_LIBRARY_PATH=.libs \
+#       python bench_gi.py [--json FILE] [--baseline FILE] [names...]
+#
+# Every benchmark is calibrated to run for at least --min-time per sample
+# and reports the best and median time per call over --repeat samples,
+# with the garbage collector disabled as timeit does.  With --baseline,
+# the medians are compared with a previous --json output and the exit
+# status is 1 when one got slower than --threshold.
+
+import gc
+import json
+import optparse
+import platform
+import sys
+import time
+
+import glib
+import gobject
+from gi.repository import GLib
+from gi.repository import GIMarshallingTests
+from gi.repository import Regress
+
+if hasattr(time, 'perf_counter'):
+    timer = time.perf_counter
+else:
+    timer = time.time
+
+try:
+    range_ = xrange
+except NameError:
+    range_ = range
+
+
+BENCHMARKS = []
+
+def benchmark(name):
+    """Register a benchmark: the decorated function does the setup and
+    returns the callable to measure."""
+    def register(setup):
+        BENCHMARKS.append((name, setup))
+        return setup
+    return register
+
+
+# invoke
+
+@benchmark('invoke_noargs')
+def bench_invoke_noargs():
+    return GIMarshallingTests.boolean_return_true
+
+@benchmark('invoke_int_in')
+def bench_invoke_int_in():
+    return lambda: Regress.test_int(42)
+
+@benchmark('invoke_double_in')
+def bench_invoke_double_in():
+    return lambda: Regress.test_double(4.2)
+
+@benchmark('invoke_utf8_in')
+def bench_invoke_utf8_in():
+    return lambda: GIMarshallingTests.utf8_none_in(GIMarshallingTests.CONSTANT_UTF8)
+
+@benchmark('invoke_utf8_return')
+def bench_invoke_utf8_return():
+    return GIMarshallingTests.utf8_none_return
+
+@benchmark('invoke_int_out_out')
+def bench_invoke_int_out_out():
+    return GIMarshallingTests.int_out_out
+
+@benchmark('invoke_utf8_out')
+def bench_invoke_utf8_out():
+    return GIMarshallingTests.utf8_none_out
+
+@benchmark('invoke_method')
+def bench_invoke_method():
+    return GIMarshallingTests.Object(int=42).method
+
+@benchmark('invoke_caller_allocates')
+def bench_invoke_caller_allocates():
+    return Regress.TestStructA().clone
+
+@benchmark('invoke_caller_allocates_out')
+def bench_invoke_caller_allocates_out():
+    struct = Regress.TestStructA()
+    out = Regress.TestStructA()
+    return lambda: struct.clone(out=out)
+
+
+# arrays
+
+def bench_array_in(n):
+    ints = list(range(n))
+    return lambda: Regress.test_array_int_in(ints)
+
+@benchmark('array_int_in_1k')
+def bench_array_int_in_1k():
+    return bench_array_in(1000)
+
+@benchmark('array_int_in_1M')
+def bench_array_int_in_1m():
+    return bench_array_in(1000000)
+
+@benchmark('array_int_out')
+def bench_array_int_out():
+    return Regress.test_array_int_out
+
+
+# callbacks and vfuncs
+
+@benchmark('callback')
+def bench_callback():
+    return lambda: Regress.test_callback(lambda: 42)
+
+@benchmark('callback_user_data')
+def bench_callback_user_data():
+    return lambda: Regress.test_callback_user_data(lambda data: data, 42)
+
+class VFuncObject(GIMarshallingTests.Object):
+    def do_method_with_default_implementation(self, int8):
+        pass
+
+@benchmark('vfunc_python_override')
+def bench_vfunc_python_override():
+    obj = VFuncObject()
+    return lambda: obj.method_with_default_implementation(42)
+
+@benchmark('vfunc_c_default')
+def bench_vfunc_c_default():
+    obj = GIMarshallingTests.Object()
+    return lambda: obj.method_with_default_implementation(42)
+
+
+# signals
+
+@benchmark('signal_emit_python_handler')
+def bench_signal_emit_python_handler():
+    obj = Regress.TestObj()
+    obj.connect('test', lambda obj: None)
+    return lambda: obj.emit('test')
+
+@benchmark('signal_emit_no_handler')
+def bench_signal_emit_no_handler():
+    obj = Regress.TestObj()
+    return lambda: obj.emit('test')
+
+@benchmark('signal_emit_c_handler')
+def bench_signal_emit_c_handler():
+    # only the C class handler of GObject::notify runs
+    obj = Regress.TestObj()
+    return lambda: obj.notify('int')
+
+@benchmark('signal_emit_from_c')
+def bench_signal_emit_from_c():
+    obj = Regress.TestObj()
+    obj.connect('sig-with-obj', lambda obj, arg: None)
+    return obj.emit_sig_with_obj
+
+
+# properties
+
+@benchmark('property_get')
+def bench_property_get():
+    obj = Regress.TestObj()
+    return lambda: obj.props.int
+
+@benchmark('property_set')
+def bench_property_set():
+    obj = Regress.TestObj()
+    def set_int():
+        obj.props.int = 42
+    return set_int
+
+@benchmark('property_get_string')
+def bench_property_get_string():
+    obj = Regress.TestObj()
+    obj.props.string = 'benchmark'
+    return lambda: obj.props.string
+
+@benchmark('gvalue_get_property')
+def bench_gvalue_get_property():
+    # goes through pyg_value_as_pyobject() rather than the GI marshaller
+    obj = Regress.TestObj()
+    return lambda: obj.get_property('int')
+
+@benchmark('gvalue_set_property')
+def bench_gvalue_set_property():
+    obj = Regress.TestObj()
+    return lambda: obj.set_property('int', 42)
+
+@benchmark('field_get')
+def bench_field_get():
+    struct = GIMarshallingTests.SimpleStruct()
+    return lambda: struct.long_
+
+@benchmark('field_set')
+def bench_field_set():
+    struct = GIMarshallingTests.SimpleStruct()
+    def set_long():
+        struct.long_ = 42
+    return set_long
+
+@benchmark('struct_as_tuple')
+def bench_struct_as_tuple():
+    return GIMarshallingTests.SimpleStruct().as_tuple
+
+@benchmark('struct_as_tuples_1k')
+def bench_struct_as_tuples_1k():
+    structs = [GIMarshallingTests.SimpleStruct() for i in range(1000)]
+    return lambda: GIMarshallingTests.SimpleStruct.as_tuples(structs)
+
+@benchmark('struct_pack_1k')
+def bench_struct_pack_1k():
+    structs = [GIMarshallingTests.SimpleStruct() for i in range(1000)]
+    return lambda: GIMarshallingTests.SimpleStruct.pack(structs)
+
+
+# wrapper creation
+
+@benchmark('object_new')
+def bench_object_new():
+    return lambda: GIMarshallingTests.Object(int=42)
+
+@benchmark('object_wrap_return')
+def bench_object_wrap_return():
+    return GIMarshallingTests.Object.full_return
+
+@benchmark('python_object_new')
+def bench_python_object_new():
+    return gobject.GObject
+
+@benchmark('boxed_new')
+def bench_boxed_new():
+    return GIMarshallingTests.BoxedStruct
+
+@benchmark('boxed_wrap_return')
+def bench_boxed_wrap_return():
+    return GIMarshallingTests.boxed_struct_returnv
+
+@benchmark('struct_new')
+def bench_struct_new():
+    return GIMarshallingTests.SimpleStruct
+
+def churn(n):
+    # keeps n wrappers of each kind alive before dropping them all
+    objects = GIMarshallingTests.Object.full_return
+    boxed = GIMarshallingTests.boxed_struct_returnv
+    structs = GIMarshallingTests.SimpleStruct
+    def run():
+        [(objects(), boxed(), structs()) for i in range_(n)]
+    return run
+
+@benchmark('wrapper_churn_100')
+def bench_wrapper_churn_100():
+    return churn(100)
+
+@benchmark('wrapper_churn_100_no_freelist')
+def bench_wrapper_churn_100_no_freelist():
+    run = churn(100)
+    limit = glib.get_freelist_limit()
+    def run_no_freelist():
+        glib.set_freelist_limit(0)
+        try:
+            run()
+        finally:
+            glib.set_freelist_limit(limit)
+    return run_no_freelist
+
+def drop_objects(n):
+    objects = GIMarshallingTests.Object.full_return
+    def run():
+        [objects() for i in range_(n)]
+    return run
+
+@benchmark('object_drop_1k')
+def bench_object_drop_1k():
+    return drop_objects(1000)
+
+@benchmark('object_drop_1k_deferred')
+def bench_object_drop_1k_deferred():
+    # the same references released in one batch, with the GIL released
+    # once instead of once per object
+    run = drop_objects(1000)
+    def run_deferred():
+        gobject.enable_deferred_unref()
+        try:
+            run()
+            gobject.flush_deferred_unref()
+        finally:
+            gobject.disable_deferred_unref()
+    return run_deferred
+
+
+# garbage collector
+
+@benchmark('gc_collect_1M_wrappers')
+def bench_gc_collect_1m_wrappers():
+    # a full collection walks every tracked object, so this is the pause
+    # an application keeping that many plain wrappers alive gets
+    wrappers = [GIMarshallingTests.Object.full_return()
+                for i in range_(1000000)]
+    def collect():
+        gc.collect()
+        return wrappers
+    return collect
+
+
+# GVariant
+
+@benchmark('variant_pack_scalar')
+def bench_variant_pack_scalar():
+    return lambda: GLib.Variant('i', 42)
+
+@benchmark('variant_pack_tuple')
+def bench_variant_pack_tuple():
+    return lambda: GLib.Variant('(isab)', (42, 'hello', [True, False]))
+
+@benchmark('variant_unpack_tuple')
+def bench_variant_unpack_tuple():
+    return GLib.Variant('(isab)', (42, 'hello', [True, False])).unpack
+
+@benchmark('variant_pack_dict')
+def bench_variant_pack_dict():
+    d = dict(('key%d' % i, i) for i in range(100))
+    return lambda: GLib.Variant('a{si}', d)
+
+@benchmark('variant_unpack_dict')
+def bench_variant_unpack_dict():
+    d = dict(('key%d' % i, i) for i in range(100))
+    return GLib.Variant('a{si}', d).unpack
+
+
+def measure(func, loops, repeat, min_time):
+    def run(loops):
+        iterations = range_(loops)
+        start = timer()
+        for i in iterations:
+            func()
+        return timer() - start
+
+    gc_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        if not loops:
+            loops = 1
+            while True:
+                elapsed = run(loops)
+                if elapsed >= min_time:
+                    break
+                loops *= max(2, min(10, int(min_time / max(elapsed, 1e-9)) + 1))
+        samples = sorted(run(loops) / loops for i in range(repeat))
+    finally:
+        if gc_enabled:
+            gc.enable()
+
+    median = samples[len(samples) // 2]
+    if len(samples) % 2 == 0:
+        median = (median + samples[len(samples) // 2 - 1]) / 2
+    return {'loops': loops,
+            'repeat': repeat,
+            'min': samples[0],
+            'median': median,
+            'max': samples[-1]}
+
+
+def compare(results, baseline, threshold):
+    previous = dict((b['name'], b) for b in baseline['benchmarks'])
+    regressions = []
+
+    print('')
+    print('%-32s %12s %12s %8s' % ('benchmark', 'baseline (us)', 'now (us)',
+                                   'change'))
+    for result in results:
+        before = previous.get(result['name'])
+        if before is None or 'median' not in result or 'median' not in before:
+            continue
+        change = result['median'] / before['median'] - 1
+        flag = ''
+        if change > threshold:
+            flag = ' !'
+            regressions.append(result['name'])
+        print('%-32s %12.3f %12.3f %+7.1f%%%s' % (result['name'],
+                                                  before['median'] * 1e6,
+                                                  result['median'] * 1e6,
+                                                  change * 100, flag))
+    return regressions
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog [options] [names...]')
+    parser.add_option('--json', metavar='FILE',
+                      help='write the results as JSON to FILE')
+    parser.add_option('--baseline', metavar='FILE',
+                      help='compare with the JSON results in FILE')
+    parser.add_option('--threshold', type='float', default=0.1,
+                      help='relative slowdown reported as a regression '
+                           '[default: %default]')
+    parser.add_option('--repeat', type='int', default=5,
+                      help='samples per benchmark [default: %default]')
+    parser.add_option('--loops', type='int', default=0,
+                      help='calls per sample, calibrated when 0 '
+                           '[default: %default]')
+    parser.add_option('--min-time', type='float', default=0.1,
+                      help='minimal duration of a calibrated sample in '
+                           'seconds [default: %default]')
+    parser.add_option('--list', action='store_true',
+                      help='list the benchmarks and exit')
+    options, names = parser.parse_args(argv)
+
+    if options.list:
+        for name, setup in BENCHMARKS:
+            print(name)
+        return 0
+
+    results = []
+    print('%-32s %12s %12s %10s' % ('benchmark', 'min (us)', 'median (us)',
+                                    'loops'))
+    for name, setup in BENCHMARKS:
+        if names and not [n for n in names if n in name]:
+            continue
+        try:
+            func = setup()
+        except (AttributeError, TypeError):
+            # not available in this typelib version
+            e = sys.exc_info()[1]
+            results.append({'name': name, 'skipped': str(e)})
+            print('%-32s skipped: %s' % (name, e))
+            continue
+        result = measure(func, options.loops, options.repeat,
+                         options.min_time)
+        result['name'] = name
+        results.append(result)
+        print('%-32s %12.3f %12.3f %10d' % (name, result['min'] * 1e6,
+                                             result['median'] * 1e6,
+                                             result['loops']))
+
+    if options.json:
+        output = {
+            'metadata': {
+                'python': platform.python_version(),
+                'implementation': platform.python_implementation(),
+                'platform': platform.platform(),
+                'pygobject': '.'.join(map(str, gobject.pygobject_version)),
+                'glib': '.'.join(map(str, gobject.glib_version)),
+                'date': time.strftime('%Y-%m-%dT%H:%M:%S'),
+            },
+            'benchmarks': results,
+        }
+        f = open(options.json, 'w')
+        try:
+            json.dump(output, f, indent=2, sort_keys=True)
+        finally:
+            f.close()
+
+    if options.baseline:
+        f = open(options.baseline)
+        try:
+            baseline = json.load(f)
+        finally:
+            f.close()
+        regressions = compare(results, baseline, options.threshold)
+        if regressions:
+            print('\n%d regression(s) over %d%%: %s' % (
+                  len(regressions), options.threshold * 100,
+                  ', '.join(regressions)))
+            return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
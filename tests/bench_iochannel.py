@@ -0,0 +1,111 @@
+# -*- Mode: Python -*-
+#
+# Pipe throughput of glib.IOChannel read()/readinto() and
+# write()/writev() compared with plain os.read()/os.write().  Run from
+# the build tree:
+#
+#   PYTHONPATH=.. python bench_iochannel.py [megabytes]
+
+import os
+import sys
+import time
+
+import glib
+
+CHUNK = 64 * 1024
+
+
+def with_child(child):
+    r, w = os.pipe()
+    pid = os.fork()
+    if pid == 0:
+        try:
+            child(r, w)
+        finally:
+            os._exit(0)
+    return pid, r, w
+
+
+def bench_read(total, kind):
+    def writer(r, w):
+        os.close(r)
+        data = b'x' * CHUNK
+        for i in range(total // CHUNK):
+            os.write(w, data)
+
+    pid, r, w = with_child(writer)
+    os.close(w)
+    channel = glib.IOChannel(r)
+    channel.set_encoding(None)
+    channel.set_buffered(False)
+    buf = bytearray(CHUNK)
+
+    start = time.time()
+    got = 0
+    while got < total:
+        if kind == 'os.read':
+            n = len(os.read(r, CHUNK))
+        elif kind == 'read':
+            n = len(channel.read(CHUNK))
+        else:
+            n = channel.readinto(buf)
+        if not n:
+            break
+        got += n
+    elapsed = time.time() - start
+
+    os.waitpid(pid, 0)
+    os.close(r)
+    return got / elapsed
+
+
+def bench_write(total, kind, pieces):
+    def reader(r, w):
+        os.close(w)
+        while os.read(r, CHUNK):
+            pass
+
+    pid, r, w = with_child(reader)
+    os.close(r)
+    channel = glib.IOChannel(w)
+    channel.set_encoding(None)
+    channel.set_buffered(False)
+    piece = b'y' * (CHUNK // pieces)
+    batch = [piece] * pieces
+
+    start = time.time()
+    sent = 0
+    while sent < total:
+        if kind == 'os.write':
+            for data in batch:
+                sent += os.write(w, data)
+        elif kind == 'write':
+            for data in batch:
+                sent += channel.write(data)
+        else:
+            sent += channel.writev(batch)
+    elapsed = time.time() - start
+
+    os.close(w)
+    os.waitpid(pid, 0)
+    return sent / elapsed
+
+
+def main(megabytes):
+    total = megabytes * 1024 * 1024
+    mb = 1024.0 * 1024.0
+
+    print('%-24s %12s' % ('read', 'MB/s'))
+    for kind in ('os.read', 'read', 'readinto'):
+        print('%-24s %12.1f' % (kind, bench_read(total, kind) / mb))
+
+    print('%-24s %12s' % ('write', 'MB/s'))
+    for pieces in (1, 16, 256):
+        for kind in ('os.write', 'write', 'writev'):
+            label = '%s x %d' % (kind, pieces)
+            print('%-24s %12.1f' % (label,
+                                    bench_write(total, kind, pieces) / mb))
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 256)
@@ -0,0 +1,65 @@
+# -*- Mode: Python -*-
+#
+# Compares glib.timeout_add() against glib.TimerWheel with many pending
+# timers.  Run from the build tree:
+#
+#   PYTHONPATH=.. python bench_timerwheel.py [counts...]
+
+import sys
+import time
+
+import glib
+
+ITERATIONS = 200
+
+
+def noop():
+    return False
+
+
+def bench(count, add, remove):
+    context = glib.main_context_default()
+
+    start = time.time()
+    ids = [add(60000 + i % 1000, noop) for i in range(count)]
+    add_time = time.time() - start
+
+    # every iteration has to look at all pending sources; an idle keeps
+    # the loop from blocking
+    idle = glib.idle_add(lambda: True)
+    start = time.time()
+    for i in range(ITERATIONS):
+        context.iteration(False)
+    iteration_time = (time.time() - start) / ITERATIONS
+    glib.source_remove(idle)
+
+    start = time.time()
+    for timer_id in ids:
+        remove(timer_id)
+    remove_time = time.time() - start
+
+    return add_time, iteration_time, remove_time
+
+
+def main(counts):
+    wheel = glib.TimerWheel(slack=10)
+    wheel.attach()
+
+    print('%8s %-12s %12s %14s %12s' % ('timers', 'kind', 'add (ms)',
+                                         'iteration (us)', 'remove (ms)'))
+    for count in counts:
+        for kind, add, remove in (('timeout_add', glib.timeout_add,
+                                   glib.source_remove),
+                                  ('TimerWheel', wheel.add,
+                                   glib.source_remove)):
+            add_time, iteration_time, remove_time = bench(count, add, remove)
+            print('%8d %-12s %12.2f %14.2f %12.2f' % (count, kind,
+                                                      add_time * 1e3,
+                                                      iteration_time * 1e6,
+                                                      remove_time * 1e3))
+
+    wheel.destroy()
+
+
+if __name__ == '__main__':
+    main([int(arg) for arg in sys.argv[1:]] or [1000, 10000, 100000])
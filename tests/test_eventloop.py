@@ -0,0 +1,209 @@
+# -*- Mode: Python -*-
+
+import asyncio
+import os
+import signal
+import sys
+import threading
+import unittest
+
+import glib
+import glib.eventloop
+
+
+class TestEventLoopSource(unittest.TestCase):
+    def setUp(self):
+        self.context = glib.MainContext()
+        self.source = glib.EventLoopSource()
+        self.source.attach(self.context)
+
+    def tearDown(self):
+        self.source.destroy()
+
+    def testCallSoon(self):
+        class Handle(object):
+            _cancelled = False
+
+            def __init__(self, calls, name):
+                self.calls = calls
+                self.name = name
+
+            def _run(self):
+                self.calls.append(self.name)
+
+        calls = []
+        cancelled = Handle(calls, 'cancelled')
+        cancelled._cancelled = True
+        for handle in (Handle(calls, 'first'), cancelled,
+                       Handle(calls, 'second')):
+            self.source.call_soon(handle)
+        self.assertEqual(len(self.source), 3)
+
+        self.context.iteration(False)
+        self.assertEqual(calls, ['first', 'second'])
+        self.assertEqual(len(self.source), 0)
+
+    def testReaderReplaced(self):
+        r, w = os.pipe()
+        try:
+            self.assertEqual(self.source.add_reader(r, 'first'), None)
+            self.assertEqual(self.source.add_reader(r, 'second'), 'first')
+            self.assertEqual(self.source.remove_reader(r), 'second')
+            self.assertEqual(self.source.remove_reader(r), None)
+        finally:
+            os.close(r)
+            os.close(w)
+
+    def testClear(self):
+        r, w = os.pipe()
+        self.addCleanup(os.close, r)
+        self.addCleanup(os.close, w)
+        handle = object()
+        refcount = sys.getrefcount(handle)
+        self.source.call_soon(handle)
+        self.source.call_at(self.source.time() + 60, handle)
+        self.source.add_reader(r, handle)
+        self.source.add_writer(w, handle)
+
+        self.source.clear()
+
+        self.assertEqual(len(self.source), 0)
+        self.assertEqual(sys.getrefcount(handle), refcount)
+        self.assertEqual(self.source.remove_reader(r), None)
+
+    def testPurgeCancelled(self):
+        class Handle(object):
+            _cancelled = False
+
+        handles = [Handle() for i in range(4)]
+        for handle in handles:
+            self.source.call_at(self.source.time() + 60, handle)
+        handles[1]._cancelled = handles[2]._cancelled = True
+
+        self.assertEqual(self.source.purge_cancelled(), 2)
+        self.assertEqual(len(self.source), 2)
+
+
+class TestEventLoop(unittest.TestCase):
+    def setUp(self):
+        self.loop = glib.eventloop.EventLoop(glib.MainContext())
+        asyncio.set_event_loop(self.loop)
+
+    def tearDown(self):
+        asyncio.set_event_loop(None)
+        self.loop.close()
+
+    def testCallbacksAndTimers(self):
+        order = []
+        for delay in (0.03, 0.01, 0.02):
+            self.loop.call_later(delay, order.append, delay)
+        self.loop.call_soon(order.append, 0)
+        self.loop.run_until_complete(asyncio.sleep(0.05))
+        self.assertEqual(order, [0, 0.01, 0.02, 0.03])
+
+    def testGLibSources(self):
+        # GLib sources on the same context run while asyncio waits
+        calls = []
+        source = glib.Idle()
+        source.set_callback(lambda: calls.append('idle'))
+        source.attach(self.loop.get_context())
+
+        self.loop.run_until_complete(asyncio.sleep(0.01))
+        self.assertTrue(calls)
+        source.destroy()
+
+    def testReader(self):
+        r, w = os.pipe()
+        self.addCleanup(os.close, r)
+        self.addCleanup(os.close, w)
+        future = self.loop.create_future()
+
+        def readable():
+            self.loop.remove_reader(r)
+            future.set_result(os.read(r, 100))
+
+        self.loop.add_reader(r, readable)
+        self.loop.call_soon(os.write, w, b'data')
+        self.assertEqual(self.loop.run_until_complete(future), b'data')
+
+    def testCallSoonThreadsafe(self):
+        future = self.loop.create_future()
+        thread = threading.Thread(
+            target=self.loop.call_soon_threadsafe,
+            args=(future.set_result, 'thread'))
+        self.loop.call_later(0.01, thread.start)
+        self.assertEqual(self.loop.run_until_complete(future), 'thread')
+        thread.join()
+
+    def testStreams(self):
+        async def handle(reader, writer):
+            writer.write((await reader.readline()).upper())
+            await writer.drain()
+            writer.close()
+
+        async def client():
+            server = await asyncio.start_server(handle, '127.0.0.1', 0)
+            port = server.sockets[0].getsockname()[1]
+            reader, writer = await asyncio.open_connection('127.0.0.1', port)
+            writer.write(b'ping\n')
+            line = await reader.readline()
+            writer.close()
+            server.close()
+            await server.wait_closed()
+            return line
+
+        self.assertEqual(self.loop.run_until_complete(client()), b'PING\n')
+
+    def testSignal(self):
+        future = self.loop.create_future()
+        self.loop.add_signal_handler(signal.SIGUSR1, future.set_result, 'usr1')
+        self.loop.call_soon(os.kill, os.getpid(), signal.SIGUSR1)
+        self.assertEqual(self.loop.run_until_complete(future), 'usr1')
+        self.assertTrue(self.loop.remove_signal_handler(signal.SIGUSR1))
+
+    def testCancelledTimersPurged(self):
+        timers = [self.loop.call_later(60, id) for i in range(300)]
+        for timer in timers[:200]:
+            timer.cancel()
+        self.assertTrue(len(self.loop._source) < 200)
+
+    def testCloseReleasesHandles(self):
+        callback = lambda: None
+        refcount = sys.getrefcount(callback)
+        self.loop.call_soon(callback)
+        self.loop.call_later(60, callback)
+
+        self.loop.close()
+
+        self.assertEqual(sys.getrefcount(callback), refcount)
+
+    def testStopBeforeRun(self):
+        calls = []
+        self.loop.call_soon(calls.append, 1)
+        self.loop.stop()
+        self.loop.run_forever()
+        self.assertEqual(calls, [1])
+
+
+class TestEventLoopPolicy(unittest.TestCase):
+    def testNewEventLoop(self):
+        policy = glib.eventloop.EventLoopPolicy()
+        loop = policy.new_event_loop()
+        try:
+            self.assertTrue(isinstance(loop, glib.eventloop.EventLoop))
+            self.assertEqual(loop.get_context(), glib.main_context_default())
+        finally:
+            loop.close()
+
+        loops = []
+        thread = threading.Thread(
+            target=lambda: loops.append(policy.new_event_loop()))
+        thread.start()
+        thread.join()
+        self.assertNotEqual(loops[0].get_context(),
+                            glib.main_context_default())
+        loops[0].close()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -104,6 +104,32 @@ class TestEverything(unittest.TestCase):
         self.assertEquals(struct_b.nested_a.some_double, struct_b_clone.nested_a.some_double)
         self.assertEquals(struct_b.nested_a.some_enum, struct_b_clone.nested_a.some_enum)
 
+    def test_caller_allocates_out(self):
+        struct_a = Everything.TestStructA()
+        struct_a.some_int = 10
+        struct_a.some_int8 = 21
+
+        out = Everything.TestStructA()
+        struct_a_clone = struct_a.clone(out=out)
+        self.assertTrue(struct_a_clone is out)
+        self.assertEquals(10, out.some_int)
+        self.assertEquals(21, out.some_int8)
+
+        struct_a.some_int = 11
+        self.assertTrue(struct_a.clone(out=(out,)) is out)
+        self.assertEquals(11, out.some_int)
+
+        # None allocates a new structure as usual
+        struct_a_clone = struct_a.clone(out=None)
+        self.assertFalse(struct_a_clone is out)
+        self.assertEquals(11, struct_a_clone.some_int)
+
+        self.assertRaises(TypeError, struct_a.clone, out=Everything.TestStructB())
+        self.assertRaises(TypeError, struct_a.clone, out=42)
+        self.assertRaises(TypeError, struct_a.clone, out=(out, out))
+        self.assertRaises(TypeError, struct_a.clone, foo=out)
+        self.assertRaises(TypeError, Everything.test_int8, 1, out=out)
+
     def test_wrong_type_of_arguments(self):
         try:
             Everything.test_int8()
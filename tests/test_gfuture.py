@@ -0,0 +1,122 @@
+# -*- Mode: Python -*-
+
+import os
+import unittest
+
+import glib
+import gio
+
+
+class TestFuture(unittest.TestCase):
+    def setUp(self):
+        self.stream = gio.MemoryInputStream()
+        self.stream.add_data(b"testing")
+
+    def testReadAsync(self):
+        future = gio.future(self.stream.read_async, 4)
+        self.assertFalse(future.done())
+        future.add_done_callback(lambda future: loop.quit())
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        self.assertTrue(future.done())
+        self.assertEqual(future.result(), b"test")
+
+    def testError(self):
+        self.stream.close()
+        future = gio.future(self.stream.read_async, 4)
+        future.add_done_callback(lambda future: loop.quit())
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        self.assertTrue(isinstance(future.exception(), gio.Error))
+        self.assertRaises(gio.Error, future.result)
+
+    def testGather(self):
+        files = []
+        for i in range(5):
+            name = "future%d.txt" % i
+            with open(name, "wb") as f:
+                f.write(name.encode())
+            files.append(gio.File(name))
+
+        try:
+            futures = [gio.future(f.load_contents_async) for f in files]
+            future = gio.gather(*futures)
+            future.add_done_callback(lambda future: loop.quit())
+
+            loop = glib.MainLoop()
+            loop.run()
+
+            self.assertEqual([contents for contents, length, etag
+                              in future.result()],
+                             [("future%d.txt" % i).encode()
+                              for i in range(5)])
+        finally:
+            for f in files:
+                os.unlink(f.get_path())
+
+    def testGatherError(self):
+        first = gio.Future()
+        second = gio.Future()
+        future = gio.gather(first, second)
+        first.set_exception(ValueError)
+        self.assertTrue(isinstance(future.exception(), ValueError))
+
+        first = gio.Future()
+        second = gio.Future()
+        future = gio.gather(first, second, return_exceptions=True)
+        first.set_exception(ValueError)
+        self.assertFalse(future.done())
+        second.set_result(1)
+        self.assertTrue(isinstance(future.result()[0], ValueError))
+        self.assertEqual(future.result()[1], 1)
+
+        self.assertRaises(TypeError, gio.gather, 1)
+
+    def testCancel(self):
+        cancellable = gio.Cancellable()
+        future = gio.future(self.stream.read_async, 4,
+                            cancellable=cancellable)
+        self.assertTrue(future.cancel())
+        self.assertTrue(future.cancelled())
+        self.assertTrue(cancellable.is_cancelled())
+        self.assertFalse(future.cancel())
+
+    def testAwait(self):
+        future = gio.Future()
+        waiter = future.__await__()
+        self.assertTrue(waiter.send(None) is future)
+        self.assertTrue(future._asyncio_future_blocking)
+
+        future.set_result(42)
+        try:
+            waiter.send(None)
+        except StopIteration as e:
+            self.assertEqual(e.value, 42)
+        else:
+            self.fail("StopIteration not raised")
+
+    def testCoroutine(self):
+        async def read():
+            return await gio.future(self.stream.read_async, 4)
+
+        coroutine = read()
+        future = coroutine.send(None)
+        future.add_done_callback(lambda future: loop.quit())
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        try:
+            coroutine.send(None)
+        except StopIteration as e:
+            self.assertEqual(e.value, b"test")
+        else:
+            self.fail("StopIteration not raised")
+
+
+if __name__ == '__main__':
+    unittest.main()
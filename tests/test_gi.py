@@ -10,8 +10,10 @@ import shutil
 import os
 import locale
 import subprocess
+import gi
 from gi.repository import GObject
 
+import glib
 import gobject
 from gi.repository import GIMarshallingTests
 
@@ -945,6 +947,15 @@ class TestGValue(unittest.TestCase):
         value.set_int(42)
         self.assertEquals('42', GIMarshallingTests.gvalue_inout(value))
 
+    def test_gvalue_out_caller_allocates_in_place(self):
+        if not hasattr(GIMarshallingTests, 'gvalue_out_caller_allocates'):
+            return
+        value = GObject.Value()
+        self.assertRaises(TypeError,
+                          GIMarshallingTests.gvalue_out_caller_allocates,
+                          out=value)
+        self.assertEquals(42, GIMarshallingTests.gvalue_out_caller_allocates())
+
 class TestGClosure(unittest.TestCase):
 
     def test_gclosure_in(self):
@@ -1220,6 +1231,90 @@ class TestStructure(unittest.TestCase):
 
         self.assertRaises(TypeError, GIMarshallingTests.SimpleStruct.method)
 
+    def test_simple_struct_fields(self):
+        struct = GIMarshallingTests.SimpleStruct()
+
+        struct.long_ = -(2 ** 31)
+        self.assertEquals(-(2 ** 31), struct.long_)
+        struct.int8 = -128
+        self.assertEquals(-128, struct.int8)
+        struct.int8 = True
+        self.assertEquals(1, struct.int8)
+
+        self.assertRaises(ValueError, setattr, struct, 'int8', 128)
+        self.assertRaises(TypeError, setattr, struct, 'int8', 'a')
+        self.assertRaises(AttributeError, delattr, struct, 'int8')
+        self.assertEquals(1, struct.int8)
+
+        field = GIMarshallingTests.SimpleStruct.__dict__['int8']
+        self.assertTrue(isinstance(field, gi._gi.FieldDescriptor))
+        self.assertTrue(GIMarshallingTests.SimpleStruct.int8 is field)
+        self.assertRaises(TypeError, field.__get__, GIMarshallingTests.NestedStruct())
+
+    def test_simple_struct_as_tuple(self):
+        struct = GIMarshallingTests.SimpleStruct()
+        struct.long_ = 6
+        struct.int8 = 7
+
+        self.assertEquals((6, 7), struct.as_tuple())
+        self.assertEquals({'long_': 6, 'int8': 7}, struct.as_dict())
+
+        struct.update(int8=-8)
+        self.assertEquals((6, -8), struct.as_tuple())
+        struct.update(long_=42, int8=1)
+        self.assertEquals((42, 1), struct.as_tuple())
+        self.assertRaises(TypeError, struct.update, foo=1)
+        self.assertRaises(ValueError, struct.update, int8=128)
+
+        copy = GIMarshallingTests.SimpleStruct.from_tuple(struct.as_tuple())
+        self.assertTrue(isinstance(copy, GIMarshallingTests.SimpleStruct))
+        self.assertEquals((42, 1), copy.as_tuple())
+        self.assertRaises(ValueError, GIMarshallingTests.SimpleStruct.from_tuple, (1,))
+
+    def test_simple_struct_batch(self):
+        import struct as struct_module
+
+        structs = [GIMarshallingTests.SimpleStruct.from_tuple((i, -i))
+                   for i in range(10)]
+        self.assertEquals([(i, -i) for i in range(10)],
+                          GIMarshallingTests.SimpleStruct.as_tuples(structs))
+
+        format = GIMarshallingTests.SimpleStruct.get_pack_format()
+        data = GIMarshallingTests.SimpleStruct.pack(structs)
+        size = struct_module.calcsize(format)
+        self.assertEquals(10 * size, len(data))
+        for i in range(10):
+            self.assertEquals((i, -i), struct_module.unpack(
+                format, data[i * size:(i + 1) * size]))
+
+        self.assertRaises(TypeError, GIMarshallingTests.SimpleStruct.as_tuples,
+                          [GIMarshallingTests.NestedStruct()])
+        self.assertRaises(TypeError, GIMarshallingTests.SimpleStruct.pack, [None])
+
+    def test_simple_struct_many(self):
+        # small structs live inside their wrapper, make sure each one
+        # gets zeroed storage of its own
+        structs = [GIMarshallingTests.SimpleStruct() for i in range(100)]
+        for i, struct in enumerate(structs):
+            self.assertEquals(0, struct.long_)
+            struct.long_ = i
+        self.assertEquals(list(range(100)), [s.long_ for s in structs])
+
+    def test_simple_struct_subclass(self):
+        class SubStruct(GIMarshallingTests.SimpleStruct):
+            pass
+
+        struct = SubStruct()
+        struct.long_ = 6
+        struct.int8 = 7
+        struct.extra = 'python attribute'
+        self.assertEquals(6, struct.long_)
+        self.assertEquals(7, struct.int8)
+        self.assertEquals('python attribute', struct.extra)
+
+        struct.method()
+
+        del struct
 
     def test_pointer_struct(self):
         self.assertTrue(issubclass(GIMarshallingTests.PointerStruct, GObject.GPointer))
@@ -1256,6 +1351,56 @@ class TestStructure(unittest.TestCase):
 
         del struct
 
+    def test_boxed_struct_as_tuple(self):
+        struct = GIMarshallingTests.BoxedStruct()
+        struct.update(long_=42)
+        self.assertEquals(42, struct.as_tuple()[0])
+        self.assertEquals(42, struct.as_dict()['long_'])
+        self.assertEquals([], struct.as_dict()['g_strv'])
+
+        # g_strv is not a number
+        self.assertRaises(TypeError, GIMarshallingTests.BoxedStruct.get_pack_format)
+        self.assertRaises(TypeError, GIMarshallingTests.BoxedStruct.pack, [struct])
+
+    def test_boxed_struct_many(self):
+        structs = [GIMarshallingTests.BoxedStruct() for i in range(100)]
+        for i, struct in enumerate(structs):
+            self.assertEquals(0, struct.long_)
+            struct.long_ = i
+        self.assertEquals(list(range(100)), [s.long_ for s in structs])
+
+    def test_struct_freelist(self):
+        if sys.version_info >= (3, 11):
+            # structures are never stored inline
+            return
+
+        def stats(name):
+            for s in glib.get_freelist_stats():
+                if s['name'] == name:
+                    return s
+            self.fail('no free list %r' % name)
+
+        GIMarshallingTests.SimpleStruct()
+        GIMarshallingTests.BoxedStruct()
+        simple = stats('SimpleStruct (inline)')
+        boxed = stats('BoxedStruct (inline)')
+
+        for i in range(10):
+            struct = GIMarshallingTests.SimpleStruct()
+            self.assertEquals(0, struct.long_)
+            struct.long_ = 42
+            del struct
+            struct = GIMarshallingTests.BoxedStruct()
+            self.assertEquals(0, struct.long_)
+            struct.long_ = 42
+            del struct
+
+        for before, after in ((simple, stats('SimpleStruct (inline)')),
+                              (boxed, stats('BoxedStruct (inline)'))):
+            self.assertEquals(10, after['allocations'] - before['allocations'])
+            self.assertEquals(10, after['releases'] - before['releases'])
+            self.assertEquals(10, after['hits'] - before['hits'])
+
     def test_boxed_struct_new(self):
         struct = GIMarshallingTests.BoxedStruct.new()
         self.assertTrue(isinstance(struct, GIMarshallingTests.BoxedStruct))
@@ -1750,3 +1895,47 @@ class TestGErrorArrayInCrash(unittest.TestCase):
     # take in GArrays. See https://bugzilla.gnome.org/show_bug.cgi?id=642708
     def test_gerror_array_in_crash(self):
         self.assertRaises(GObject.GError, GIMarshallingTests.gerror_array_in, [1, 2, 3])
+
+class TestInvokeStats(unittest.TestCase):
+    def setUp(self):
+        gi._gi.enable_invoke_stats()
+
+    def tearDown(self):
+        gi._gi.enable_invoke_stats(False)
+
+    def test_disabled(self):
+        gi._gi.enable_invoke_stats(False)
+        GIMarshallingTests.boolean_return_true()
+        self.assertEquals([], gi._gi.get_invoke_stats())
+
+    def test_records(self):
+        for i in range(3):
+            GIMarshallingTests.int_in(42)
+        self.assertRaises(GObject.GError, GIMarshallingTests.gerror_array_in, [1, 2, 3])
+
+        stats = dict((record['name'], record)
+                     for record in gi._gi.get_invoke_stats())
+        record = stats['GIMarshallingTests.int_in']
+        self.assertEquals(3, record['calls'])
+        self.assertEquals(0, record['errors'])
+        for phase in ('prepare_time', 'invoke_time', 'process_time', 'release_time'):
+            self.assertTrue(record[phase] >= 0)
+        self.assertEquals(1, stats['GIMarshallingTests.gerror_array_in']['errors'])
+
+    def test_method(self):
+        GIMarshallingTests.Object(int=42).method()
+        names = [record['name'] for record in gi._gi.get_invoke_stats()]
+        self.assertTrue('GIMarshallingTests.Object.method' in names)
+
+    def test_reset(self):
+        GIMarshallingTests.boolean_return_true()
+        self.assertEquals(1, len(gi._gi.get_invoke_stats(reset=True)))
+        self.assertEquals([], gi._gi.get_invoke_stats())
+
+    def test_report(self):
+        GIMarshallingTests.int_in(42)
+        GIMarshallingTests.boolean_return_true()
+        GIMarshallingTests.boolean_return_true()
+        report = gi.invoke_stats_report(limit=1, sort='calls').split('\n')
+        self.assertEquals(2, len(report))
+        self.assertTrue(report[1].startswith('GIMarshallingTests.boolean_return_true'))
@@ -447,6 +447,26 @@ class TestFile(unittest.TestCase):
         loop = glib.MainLoop()
         loop.run()
 
+    def testLoadContentsMapped(self):
+        self._f.write("testing")
+        self._f.flush()
+
+        contents = self.file.load_contents_mapped()
+        self.failUnless(contents.mapped)
+        self.assertEqual(len(contents), 7)
+        view = memoryview(contents)
+        self.failUnless(view.readonly)
+        self.assertEqual(view.tobytes(), "testing")
+
+        # the mapping stays valid as long as a view of it exists
+        del contents
+        self.assertEqual(view[:4].tobytes(), "test")
+
+    def testLoadContentsMappedEmpty(self):
+        contents = self.file.load_contents_mapped()
+        self.failIf(contents.mapped)
+        self.assertEqual(memoryview(contents).tobytes(), "")
+
     def testReplaceContents(self):
         self.file.replace_contents("testing replace_contents")
         cont, leng, etag = self.file.load_contents()
@@ -527,6 +547,20 @@ class TestGFileEnumerator(unittest.TestCase):
         else:
             raise AssertionError
 
+    def testNextFiles(self):
+        names = [info.get_name() for info in
+                 self.file.enumerate_children("standard::name")]
+
+        enumerator = self.file.enumerate_children("standard::name")
+        first = enumerator.next_file()
+        batch = enumerator.next_files(3)
+        self.assertEqual(len(batch), 3)
+        rest = [info.get_name() for info in enumerator]
+        self.assertEqual(enumerator.next_files(3), [])
+
+        self.assertEqual([first.get_name()] +
+                         [info.get_name() for info in batch] + rest, names)
+
     def testEnumerateChildrenAsync(self):
         def callback(gfile, result):
             try:
@@ -605,6 +639,27 @@ class TestInputStream(unittest.TestCase):
                                              50),
                           some_data)
 
+    def testReadinto(self):
+        buf = bytearray(4)
+        self.assertEquals(self.stream.readinto(buf), 4)
+        self.assertEquals(str(buf), "test")
+        self.assertEquals(self.stream.readinto(buf), 3)
+        self.assertEquals(str(buf[:3]), "ing")
+        self.assertEquals(self.stream.readinto(buf), 0)
+
+        self.assertRaises(TypeError, self.stream.readinto, "read-only")
+
+    def testIterChunks(self):
+        stream = gio.MemoryInputStream()
+        some_data = open(__file__, "rb").read()
+        stream.add_data(some_data)
+
+        chunks = []
+        for chunk in stream.iter_chunks(100):
+            self.assert_(len(chunk) <= 100)
+            chunks.append(chunk.tobytes())
+        self.assertEquals(''.join(chunks), some_data)
+
     def testSkip(self):
         self.stream.skip(2)
         res = self.stream.read()
@@ -789,6 +844,15 @@ class TestMemoryInputStream(unittest.TestCase):
         stream = gio.memory_input_stream_new_from_data('spam')
         self.assertEquals('spam', stream.read())
 
+    def test_add_data_buffer(self):
+        data = bytearray('foo')
+        self.stream.add_data(data)
+        self.stream.add_data(memoryview('bar'))
+        # the stream reads the bytearray's memory, which may not be
+        # resized while it is in use
+        self.assertRaises(BufferError, data.extend, 'baz')
+        self.assertEquals('foobar', self.stream.read())
+
 
 class TestOutputStream(unittest.TestCase):
     def setUp(self):
@@ -837,6 +901,19 @@ class TestOutputStream(unittest.TestCase):
         loop = glib.MainLoop()
         loop.run()
 
+    def testWriteAsyncBuffer(self):
+        def callback(stream, result):
+            try:
+                self.assertEquals(stream.write_finish(result), 7)
+                self.assertEquals(open("outputstream.txt").read(), "testing")
+            finally:
+                loop.quit()
+
+        self.stream.write_async(bytearray("testing"), callback)
+
+        loop = glib.MainLoop()
+        loop.run()
+
     def testWriteAsyncError(self):
         def callback(stream, result):
             self.assertEquals(result.get_op_res_gssize(), 0)
@@ -907,6 +984,73 @@ class TestOutputStream(unittest.TestCase):
         loop = glib.MainLoop()
         loop.run()
 
+    def testPumpAsync(self):
+        data = os.urandom(300000)
+        source = gio.MemoryInputStream()
+        source.add_data(data)
+        dest = gio.MemoryOutputStream()
+        progress = []
+
+        def callback(stream, result):
+            try:
+                self.assertEquals(stream.pump_finish(result), len(data))
+            finally:
+                loop.quit()
+
+        dest.pump_async(source, callback, progress.append,
+                        chunk_size=4096, n_buffers=3, progress_rate=1e6)
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        self.assertEquals(dest.get_contents(), data)
+        self.failUnless(progress)
+        self.assertEquals(progress, sorted(progress))
+        self.failUnless(progress[-1] <= len(data))
+
+    def testPumpAsyncFd(self):
+        _f = open("stream.txt", "w+")
+        _f.write("testing" * 10000)
+        _f.seek(0)
+        instream = gio.unix.InputStream(_f.fileno(), False)
+
+        def callback(stream, result):
+            try:
+                self.assertEquals(stream.pump_finish(result), 70000)
+            finally:
+                loop.quit()
+
+        self.stream.pump_async(instream, callback, chunk_size=1024)
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        _f.close()
+        os.unlink("stream.txt")
+        self._f.flush()
+        self.assertEquals(open("outputstream.txt").read(), "testing" * 10000)
+
+    def testPumpAsyncCancel(self):
+        source = gio.MemoryInputStream()
+        source.add_data("testing")
+        cancellable = gio.Cancellable()
+        cancellable.cancel()
+
+        def callback(stream, result):
+            try:
+                self.assertRaises(gio.Error, stream.pump_finish, result)
+            finally:
+                loop.quit()
+
+        self.stream.pump_async(source, callback, cancellable=cancellable)
+
+        loop = glib.MainLoop()
+        loop.run()
+
+        self.assertRaises(TypeError, self.stream.pump_async, "foo", callback)
+        self.assertRaises(ValueError, self.stream.pump_async, source,
+                          callback, chunk_size=0)
+
 class TestMemoryOutputStream(unittest.TestCase):
     def setUp(self):
         self.stream = gio.MemoryOutputStream()
@@ -1046,6 +1190,21 @@ class TestFileInputStream(unittest.TestCase):
         loop = glib.MainLoop()
         loop.run()
 
+    def testReadLarge(self):
+        # the size hint makes this a single read; the result must not
+        # depend on it being right
+        data = "0123456789" * 100000
+        self._f.seek(0, 2)
+        self._f.write(data)
+        self._f.flush()
+
+        inputstream = self.file.read()
+        self.assertEquals(inputstream.read(), "testing" + data)
+
+        inputstream = self.file.read()
+        inputstream.skip(7)
+        self.assertEquals(inputstream.read_all(), data)
+
 class TestFileOutputStream(unittest.TestCase):
     def setUp(self):
         self._f = open("file.txt", "w+")
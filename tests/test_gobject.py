@@ -1,7 +1,9 @@
 # -*- Mode: Python -*-
 
+import gc
 import unittest
 
+import glib
 import gobject
 import sys
 import testhelper
@@ -161,6 +163,212 @@ class TestReferenceCounting(unittest.TestCase):
         obj.release()
         self.assertEquals(obj.__grefcount__, 1)
 
+class Slots(gobject.GObject):
+    __slots__ = ('value',)
+
+class TestGarbageCollection(unittest.TestCase):
+    # wrappers only hold Python references through their instance dict
+    # and the closures connected to them
+
+    def testPlainWrapperIsUntracked(self):
+        obj = gobject.new(gobject.GObject)
+        self.assertFalse(gc.is_tracked(obj))
+
+    def testTrackedWhenAttributeSet(self):
+        obj = gobject.new(gobject.GObject)
+        obj.value = 42
+        self.assertTrue(gc.is_tracked(obj))
+
+    def testTrackedWhenDictCreated(self):
+        obj = gobject.new(gobject.GObject)
+        obj.__dict__
+        self.assertTrue(gc.is_tracked(obj))
+
+    def testTrackedWhenConnected(self):
+        obj = gobject.new(gobject.GObject)
+        obj.connect('notify', lambda obj, pspec: None)
+        self.assertTrue(gc.is_tracked(obj))
+
+    def testSlotsWrapperIsTracked(self):
+        obj = gobject.new(Slots)
+        self.assertTrue(gc.is_tracked(obj))
+
+    def testUntrackedWrapperDealloc(self):
+        for i in range(100):
+            gobject.new(gobject.GObject)
+        gc.collect()
+
+
+class TestWrapperFreeList(unittest.TestCase):
+    def stats(self):
+        for s in glib.get_freelist_stats():
+            if s['name'] == 'gobject.GObject':
+                return s
+        self.fail('no free list for gobject.GObject')
+
+    def testWrappersReused(self):
+        gobject.new(gobject.GObject)
+        before = self.stats()
+        for i in range(10):
+            obj = gobject.new(gobject.GObject)
+            self.assertEquals(obj.__grefcount__, 1)
+            del obj
+        after = self.stats()
+        self.assertEquals(10, after['allocations'] - before['allocations'])
+        self.assertEquals(10, after['releases'] - before['releases'])
+        if sys.version_info < (3, 11):
+            self.assertEquals(10, after['hits'] - before['hits'])
+
+    def testLimit(self):
+        limit = glib.get_freelist_limit()
+        try:
+            glib.set_freelist_limit(0)
+            objs = [gobject.new(gobject.GObject) for i in range(10)]
+            del objs
+            self.assertEquals(0, self.stats()['length'])
+        finally:
+            glib.set_freelist_limit(limit)
+        self.assertRaises(ValueError, glib.set_freelist_limit, -1)
+
+
+class TestDeferredUnref(unittest.TestCase):
+    def tearDown(self):
+        gobject.disable_deferred_unref()
+
+    def testIdleQueue(self):
+        finalized = []
+        gobject.enable_deferred_unref()
+        obj = gobject.new(gobject.GObject)
+        ref = obj.weak_ref(lambda: finalized.append(True))
+        del obj
+        self.assertEquals([], finalized)
+        self.assertTrue(gobject.get_deferred_unref_stats()['idle_queue_length'] >= 1)
+
+        context = glib.main_context_default()
+        while context.pending():
+            context.iteration(False)
+        self.assertEquals([True], finalized)
+        self.assertEquals(0, gobject.get_deferred_unref_stats()['idle_queue_length'])
+
+    def testFlush(self):
+        gobject.enable_deferred_unref()
+        before = gobject.get_deferred_unref_stats()
+        objs = [gobject.new(gobject.GObject) for i in range(10)]
+        del objs
+        self.assertEquals(10, gobject.flush_deferred_unref())
+        after = gobject.get_deferred_unref_stats()
+        self.assertEquals(10, after['queued'] - before['queued'])
+        self.assertEquals(10, after['released'] - before['released'])
+
+    def testDisableFlushes(self):
+        finalized = []
+        gobject.enable_deferred_unref()
+        obj = gobject.new(gobject.GObject)
+        ref = obj.weak_ref(lambda: finalized.append(True))
+        del obj
+        gobject.disable_deferred_unref()
+        self.assertEquals([True], finalized)
+        self.assertFalse(gobject.get_deferred_unref_stats()['enabled'])
+
+    def testThreadQueue(self):
+        gobject.enable_deferred_unref(thread_safe=[gobject.GObject])
+        before = gobject.get_deferred_unref_stats()['released']
+        objs = [gobject.new(gobject.GObject) for i in range(10)]
+        del objs
+        gobject.flush_deferred_unref()
+        stats = gobject.get_deferred_unref_stats()
+        self.assertEquals(10, stats['released'] - before)
+        self.assertEquals(0, stats['thread_queue_length'])
+        self.assertEquals(0, stats['idle_queue_length'])
+
+    def testInvalidTypes(self):
+        self.assertRaises(TypeError, gobject.enable_deferred_unref, 42)
+        self.assertRaises(TypeError, gobject.enable_deferred_unref,
+                          thread_safe=[int])
+
+
+class TestClassLookup(unittest.TestCase):
+    def testResolvedOnce(self):
+        cls = type(testhelper.get_test_thread())
+        self.assertTrue(type(testhelper.get_test_thread()) is cls)
+
+    def testPytypeReassigned(self):
+        cls = type(testhelper.get_test_thread())
+
+        class Override(cls):
+            pass
+
+        cls.__gtype__.pytype = Override
+        try:
+            self.assertTrue(type(testhelper.get_test_thread()) is Override)
+        finally:
+            cls.__gtype__.pytype = cls
+        self.assertTrue(type(testhelper.get_test_thread()) is cls)
+
+
+class TestGValueConverters(unittest.TestCase):
+    def testCustomMarshallerRegisteredLater(self):
+        # no marshaller yet: the converters cached for the type say so
+        boxed = testhelper.test_custom_boxed_get(42)
+        self.assertTrue(isinstance(boxed, gobject.GBoxed))
+        self.assertRaises(TypeError, testhelper.test_custom_boxed_set, 7)
+
+        testhelper.register_custom_boxed_marshaller()
+
+        self.assertEqual(testhelper.test_custom_boxed_get(42), 42)
+        self.assertEqual(testhelper.test_custom_boxed_set(7), 7)
+
+
+class TestToggleBatching(unittest.TestCase):
+    def setUp(self):
+        gobject.enable_toggle_batching()
+
+    def tearDown(self):
+        gobject.disable_toggle_batching()
+
+    def testQueuedFromThread(self):
+        obj = gobject.GObject()
+        obj.value = 42  # switches the wrapper to a toggle reference
+        refcount = sys.getrefcount(obj)
+        before = gobject.get_toggle_batching_stats()
+
+        # only the first reference taken notifies a toggle: the queued
+        # notification keeps the object referenced until it is applied
+        testhelper.test_ref_unref_in_thread(obj, 1000)
+        stats = gobject.get_toggle_batching_stats()
+        self.assertEquals(1, stats['queue_length'])
+        self.assertEquals(2, obj.__grefcount__)
+        self.assertEquals(refcount, sys.getrefcount(obj))
+
+        context = glib.main_context_default()
+        while context.pending():
+            context.iteration(False)
+        after = gobject.get_toggle_batching_stats()
+        self.assertEquals(0, after['queue_length'])
+        self.assertEquals(1, after['applied'] - before['applied'])
+        self.assertEquals(1, obj.__grefcount__)
+        self.assertEquals(refcount, sys.getrefcount(obj))
+
+    def testWrapperDiesWithQueuedToggle(self):
+        obj = gobject.GObject()
+        obj.value = 42
+        testhelper.test_ref_unref_in_thread(obj, 1)
+        del obj
+        self.assertEquals(0, gobject.get_toggle_batching_stats()['queue_length'])
+
+    def testDisableApplies(self):
+        obj = gobject.GObject()
+        obj.value = 42
+        testhelper.test_ref_unref_in_thread(obj, 1)
+        gobject.disable_toggle_batching()
+        self.assertEquals(1, obj.__grefcount__)
+        self.assertFalse(gobject.get_toggle_batching_stats()['enabled'])
+
+if sys.version_info < (3, 4):
+    # toggle batching needs PyGILState_Check(), new in Python 3.4
+    del TestToggleBatching
+
+
 class A(gobject.GObject):
     def __init__(self):
         super(A, self).__init__()
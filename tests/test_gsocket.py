@@ -26,6 +26,57 @@ class TestSocket(unittest.TestCase):
     def tearDown(self):
         self.sock.close()
 
+class TestSocketVectoredIO(unittest.TestCase):
+    def setUp(self):
+        address = gio.InetSocketAddress(
+            gio.inet_address_new_from_string("127.0.0.1"), 0)
+        self.receiver = gio.Socket(gio.SOCKET_FAMILY_IPV4,
+                                   gio.SOCKET_TYPE_DATAGRAM,
+                                   gio.SOCKET_PROTOCOL_UDP)
+        self.receiver.bind(address, False)
+        self.address = self.receiver.get_local_address()
+        self.sender = gio.Socket(gio.SOCKET_FAMILY_IPV4,
+                                 gio.SOCKET_TYPE_DATAGRAM,
+                                 gio.SOCKET_PROTOCOL_UDP)
+
+    def tearDown(self):
+        self.sender.close()
+        self.receiver.close()
+
+    def test_send_receive_message(self):
+        sent = self.sender.send_message(["head", bytearray("-"), "tail"],
+                                        self.address)
+        self.assertEqual(sent, 9)
+
+        first, second = bytearray(4), bytearray(16)
+        received, address, flags = self.receiver.receive_message(
+            [first, second])
+        self.assertEqual(received, 9)
+        self.failUnless(isinstance(address, gio.InetSocketAddress))
+        self.assertEqual(str(first), "head")
+        self.assertEqual(str(second[:5]), "-tail")
+
+    def test_receive_into(self):
+        self.sender.send_to(self.address, "datagram")
+        buf = bytearray(64)
+        self.assertEqual(self.receiver.receive_into(buf), 8)
+        self.assertEqual(str(buf[:8]), "datagram")
+
+    def test_receive_batch(self):
+        for i in range(5):
+            self.sender.send_to(self.address, "packet %d" % i)
+
+        buf = bytearray(16 * 8)
+        lengths = self.receiver.receive_batch(buf, 16)
+        # all five were queued on loopback before the call
+        self.assertEqual(len(lengths), 5)
+        for i, length in enumerate(lengths):
+            self.assertEqual(str(buf[i * 16:i * 16 + length]),
+                             "packet %d" % i)
+
+        self.assertRaises(ValueError, self.receiver.receive_batch, buf, 0)
+
+
 class TestSocketAddress(unittest.TestCase):
     def test_socket_address_enumerator_next_async(self):
         def callback(enumerator, result):
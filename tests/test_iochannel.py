@@ -0,0 +1,130 @@
+# -*- Mode: Python -*-
+
+import os
+import unittest
+
+import glib
+
+
+class TestIOChannel(unittest.TestCase):
+    def setUp(self):
+        self.r, self.w = os.pipe()
+        self.reader = glib.IOChannel(self.r)
+        self.writer = glib.IOChannel(self.w)
+        for channel in (self.reader, self.writer):
+            channel.set_encoding(None)
+
+    def tearDown(self):
+        os.close(self.r)
+        os.close(self.w)
+
+    def testReadinto(self):
+        os.write(self.w, b'hello world')
+        buf = bytearray(5)
+        self.assertEqual(self.reader.readinto(buf), 5)
+        self.assertEqual(buf, bytearray(b'hello'))
+
+        buf = bytearray(6)
+        view = memoryview(buf)
+        self.assertEqual(self.reader.readinto(view), 6)
+        self.assertEqual(buf, bytearray(b' world'))
+
+    def testReadintoShort(self):
+        self.reader.set_buffered(False)
+        os.write(self.w, b'abc')
+        buf = bytearray(64)
+        # must not wait for the rest of the buffer to be filled
+        self.assertEqual(self.reader.readinto(buf), 3)
+        self.assertEqual(buf[:3], bytearray(b'abc'))
+
+    def testReadintoReadOnly(self):
+        self.assertRaises(TypeError, self.reader.readinto, b'immutable')
+
+    def testWritevBuffered(self):
+        count = self.writer.writev([b'foo', bytearray(b'bar'),
+                                    memoryview(b'baz')])
+        self.assertEqual(count, 9)
+        self.writer.flush()
+        self.assertEqual(os.read(self.r, 100), b'foobarbaz')
+
+    def testWritevUnbuffered(self):
+        self.writer.set_buffered(False)
+        buffers = [b'x' * i for i in range(100)]
+        count = self.writer.writev(buffers)
+        self.assertEqual(count, sum(len(b) for b in buffers))
+
+        data = b''
+        while len(data) < count:
+            data += os.read(self.r, count)
+        self.assertEqual(data, b''.join(buffers))
+
+    def testWritevNotBuffer(self):
+        self.assertRaises(TypeError, self.writer.writev, [b'foo', 42])
+
+    def testWritelines(self):
+        self.writer.writelines(['foo\n', 'bar\n'])
+        self.writer.flush()
+        self.assertEqual(os.read(self.r, 100), b'foo\nbar\n')
+
+
+class TestLineWatch(unittest.TestCase):
+    def setUp(self):
+        self.r, self.w = os.pipe()
+        self.channel = glib.IOChannel(self.r)
+        self.channel.set_encoding(None)
+        self.channel.set_buffered(False)
+        self.loop = glib.MainLoop()
+        self.batches = []
+
+    def tearDown(self):
+        os.close(self.r)
+
+    def callback(self, channel, lines):
+        self.assertEqual(channel, self.channel)
+        self.batches.append(lines)
+        if not lines:
+            self.loop.quit()
+        return True
+
+    def run_watch(self, data, **kwargs):
+        self.channel.add_line_watch(self.callback, **kwargs)
+        os.write(self.w, data)
+        os.close(self.w)
+        self.loop.run()
+
+    def testLines(self):
+        self.run_watch(b'one\ntwo\nthree', max_lines=0)
+        self.assertEqual(self.batches,
+                         [[b'one\n', b'two\n'], [b'three'], []])
+
+    def testMaxLines(self):
+        self.run_watch(b'a\nb\nc\nd\ne\n', max_lines=2)
+        self.assertEqual(self.batches,
+                         [[b'a\n', b'b\n'], [b'c\n', b'd\n'], [b'e\n'], []])
+
+    def testMaxLineLength(self):
+        self.run_watch(b'0123456789\nab\n', max_line_length=4)
+        self.assertEqual(sum(self.batches, []),
+                         [b'0123', b'4567', b'89\n', b'ab\n'])
+
+    def testUserData(self):
+        def callback(channel, lines, user_data):
+            user_data.extend(lines)
+            if not lines:
+                self.loop.quit()
+            return True
+
+        received = []
+        self.channel.add_line_watch(callback, received)
+        os.write(self.w, b'x\ny\n')
+        os.close(self.w)
+        self.loop.run()
+        self.assertEqual(received, [b'x\n', b'y\n'])
+
+    def testBuffered(self):
+        channel = glib.IOChannel(self.w)
+        self.assertRaises(ValueError, channel.add_line_watch, self.callback)
+        os.close(self.w)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -49,3 +49,93 @@ class TestMainLoop(unittest.TestCase):
         #
         sys.excepthook = sys.__excepthook__
         assert not got_exception
+
+
+class TestDispatchStats(unittest.TestCase):
+    def setUp(self):
+        self.context = glib.MainContext()
+        self.assertTrue(self.context.enable_dispatch_stats())
+
+    def tearDown(self):
+        self.context.disable_dispatch_stats()
+
+    def iterate(self):
+        while self.context.pending():
+            self.context.iteration(False)
+
+    def testDisabled(self):
+        context = glib.MainContext()
+        self.assertEqual(context.get_dispatch_stats(), [])
+        self.assertFalse(context.disable_dispatch_stats())
+        self.assertFalse(self.context.enable_dispatch_stats())
+
+    def testRecords(self):
+        def callback():
+            return False
+
+        source = glib.Idle()
+        source.set_callback(callback)
+        source_id = source.attach(self.context)
+        self.iterate()
+
+        stats = self.context.get_dispatch_stats()
+        self.assertEqual(len(stats), 1)
+        record = stats[0]
+        self.assertEqual(record['id'], source_id)
+        self.assertTrue(record['callback'].endswith('callback'))
+        self.assertEqual(record['count'], 1)
+        self.assertTrue(record['max_time'] <= record['total_time'])
+        self.assertEqual(sum(record['time_histogram']), 1)
+        self.assertEqual(sum(record['latency_histogram']), 1)
+        self.assertEqual(len(record['time_histogram']),
+                         len(glib.DISPATCH_HISTOGRAM_BOUNDS))
+
+    def testSourceSubclass(self):
+        class Ready(glib.Source):
+            def prepare(self):
+                return True, 0
+
+            def dispatch(self, callback, args):
+                return False
+
+        source = Ready()
+        source.attach(self.context)
+        self.iterate()
+
+        record = self.context.get_dispatch_stats()[0]
+        self.assertTrue(record['callback'].endswith('Ready'))
+
+    def testReset(self):
+        for i in range(3):
+            source = glib.Idle()
+            source.set_callback(lambda: False)
+            source.attach(self.context)
+        self.iterate()
+
+        self.assertEqual(len(self.context.get_dispatch_stats(reset=True)), 3)
+        self.assertEqual(self.context.get_dispatch_stats(), [])
+        self.context.reset_dispatch_stats()
+
+    def testResetError(self):
+        class Bad(object):
+            def __bool__(self):
+                raise ValueError
+            __nonzero__ = __bool__
+
+        self.assertRaises(ValueError, self.context.get_dispatch_stats,
+                          reset=Bad())
+
+    def testOverflow(self):
+        self.context.disable_dispatch_stats()
+        self.context.enable_dispatch_stats(max_sources=2)
+        for i in range(5):
+            source = glib.Idle()
+            source.set_callback(lambda: False)
+            source.attach(self.context)
+        self.iterate()
+
+        # two records plus the one sources past the limit share
+        stats = self.context.get_dispatch_stats()
+        self.assertEqual(len(stats), 3)
+        self.assertEqual(sum(record['count'] for record in stats), 5)
+        self.assertTrue(0 in [record['id'] for record in stats])
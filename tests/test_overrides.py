@@ -973,6 +973,22 @@ class TestGtk(unittest.TestCase):
         self.assertFalse(p1 < None)
         self.assertFalse(p1 <= None)
 
+    def test_tree_model_out_iter(self):
+        list_store = Gtk.ListStore(int)
+        for i in range(3):
+            list_store.append((i,))
+
+        treeiter = Gtk.TreeIter()
+        self.assertTrue(list_store.get_iter_first(out=treeiter) is treeiter)
+        self.assertEqual(0, list_store.get_value(treeiter, 0))
+        self.assertTrue(list_store.get_iter('2', out=treeiter) is treeiter)
+        self.assertEqual(2, list_store.get_value(treeiter, 0))
+        self.assertTrue(list_store.iter_nth_child(None, 1, out=treeiter) is treeiter)
+        self.assertEqual(1, list_store.get_value(treeiter, 0))
+
+        self.assertEqual(None, Gtk.ListStore(int).get_iter_first(out=treeiter))
+        self.assertRaises(TypeError, list_store.get_iter_first, out=Gdk.Rectangle())
+
     def test_tree_model(self):
         tree_store = Gtk.TreeStore(int, str)
 
@@ -1429,6 +1445,19 @@ class TestGio(unittest.TestCase):
 
         self.assertEquals(iter_info, next_info)
 
+        prefetch_info = []
+        enumerator = f.enumerate_children("standard::*", 0, None)
+        for info in enumerator.prefetch(3):
+            prefetch_info.append(info.get_name())
+
+        self.assertEquals(iter_info, prefetch_info)
+
+        # stopping early must leave the enumerator usable
+        enumerator = f.enumerate_children("standard::*", 0, None)
+        for info in enumerator.prefetch(1):
+            break
+        self.assertEquals(enumerator.next_file(None).get_name(), iter_info[2])
+
     def test_gsettings_native(self):
         self.assertTrue('test-array' in self.settings.list_keys())
 
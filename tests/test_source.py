@@ -1,5 +1,7 @@
 # -*- Mode: Python -*-
 
+import os
+import sys
 import unittest
 
 import glib
@@ -89,6 +91,57 @@ class TestSource(unittest.TestCase):
 
         assert dispatched[0]
 
+    def testPollOnly(self):
+        # no prepare/check/dispatch overrides: readiness of the fds added
+        # with add_poll() is checked in C and the callback runs directly
+        r, w = os.pipe()
+        loop = glib.MainLoop()
+        received = []
+
+        def callback():
+            received.append(os.read(r, 1))
+            loop.quit()
+            return False
+
+        source = glib.Source()
+        pollfd = glib.PollFD(r, glib.IO_IN)
+        source.add_poll(pollfd)
+        source.set_callback(callback)
+        source.attach()
+        glib.timeout_add(10, lambda: os.write(w, b'x') and False)
+
+        loop.run()
+        os.close(r)
+        os.close(w)
+
+        self.assertEqual(received, [b'x'])
+
+    def testReadyTime(self):
+        loop = glib.MainLoop()
+        fired = []
+
+        source = glib.Source()
+        self.assertEqual(source.get_ready_time(), -1)
+        deadline = source.get_time() + 20000
+        source.set_ready_time(deadline)
+        self.assertEqual(source.get_ready_time(), deadline)
+
+        def callback():
+            fired.append(source.get_time())
+            loop.quit()
+            return False
+
+        source.set_callback(callback)
+        source.attach()
+
+        loop.run()
+
+        self.assertEqual(len(fired), 1)
+        self.assertTrue(fired[0] >= deadline)
+
+    def testReadyTimeNotPython(self):
+        self.assertRaises(TypeError, glib.Idle().set_ready_time, 0)
+
 
 class TestTimeout(unittest.TestCase):
      def test504337(self):
@@ -96,5 +149,137 @@ class TestTimeout(unittest.TestCase):
         idle_source = glib.Idle()
 
 
+class TestTimerWheel(unittest.TestCase):
+    def setUp(self):
+        self.loop = glib.MainLoop()
+        self.wheel = glib.TimerWheel(slack=5)
+        self.wheel.attach()
+        glib.timeout_add(2000, self.loop.quit)
+
+    def tearDown(self):
+        self.wheel.destroy()
+
+    def testReinit(self):
+        wheel = glib.TimerWheel()
+        self.assertRaises(RuntimeError, wheel.__init__)
+        wheel.destroy()
+
+    def testDestroy(self):
+        wheel = glib.TimerWheel()
+        wheel.attach()
+        callback = lambda: False
+        timer_id = wheel.add(10000, callback)
+        refcount = sys.getrefcount(callback)
+
+        wheel.destroy()
+
+        self.assertFalse(glib.source_remove(timer_id))
+        self.assertEqual(sys.getrefcount(callback), refcount - 1)
+        self.assertRaises(RuntimeError, len, wheel)
+
+    def testDestroyFromCallback(self):
+        wheel = glib.TimerWheel()
+        wheel.attach()
+
+        def callback():
+            wheel.destroy()
+            self.loop.quit()
+            return True
+
+        timer_id = wheel.add(1, callback)
+        wheel.add(10000, callback)
+        self.loop.run()
+
+        self.assertFalse(glib.source_remove(timer_id))
+
+    def testFiresInOrder(self):
+        fired = []
+
+        def callback(tag):
+            fired.append(tag)
+            if len(fired) == 3:
+                self.loop.quit()
+            return False
+
+        self.wheel.add(60, callback, 'c')
+        self.wheel.add(1, callback, 'a')
+        self.wheel.add(30, callback, 'b')
+        self.assertEqual(len(self.wheel), 3)
+
+        self.loop.run()
+
+        self.assertEqual(fired, ['a', 'b', 'c'])
+        self.assertEqual(len(self.wheel), 0)
+
+    def testRepeat(self):
+        count = [0]
+
+        def callback():
+            count[0] += 1
+            if count[0] == 3:
+                self.loop.quit()
+                return False
+            return True
+
+        self.wheel.add(5, callback)
+        self.loop.run()
+
+        self.assertEqual(count[0], 3)
+        self.assertEqual(len(self.wheel), 0)
+
+    def testSourceRemove(self):
+        fired = []
+
+        def callback(tag):
+            fired.append(tag)
+            self.loop.quit()
+            return False
+
+        timer_id = self.wheel.add(10, callback, 'removed')
+        self.wheel.add(50, callback, 'kept')
+        self.assertTrue(glib.source_remove(timer_id))
+        self.assertFalse(self.wheel.remove(timer_id))
+
+        self.loop.run()
+
+        self.assertEqual(fired, ['kept'])
+
+    def testRemoveFromCallback(self):
+        count = [0]
+
+        def callback():
+            count[0] += 1
+            self.wheel.remove(timer_id)
+            glib.timeout_add(50, self.loop.quit)
+            return True
+
+        timer_id = self.wheel.add(1, callback)
+        self.loop.run()
+
+        self.assertEqual(count[0], 1)
+        self.assertEqual(len(self.wheel), 0)
+
+    def testManyTimers(self):
+        fired = [0]
+
+        def callback():
+            fired[0] += 1
+            if fired[0] == 10000:
+                self.loop.quit()
+            return False
+
+        for i in range(10000):
+            self.wheel.add(i % 300, callback)
+        ids = [self.wheel.add(100000, callback) for i in range(100)]
+
+        self.loop.run()
+
+        self.assertEqual(fired[0], 10000)
+        self.assertEqual(len(self.wheel), 100)
+        for timer_id in ids:
+            self.assertTrue(glib.source_remove(timer_id))
+        self.assertEqual(len(self.wheel), 0)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -436,6 +436,136 @@ _wrap_test_value_array(PyObject *self, PyObject *args)
   return pyg_value_as_pyobject(value, FALSE);
 }
 
+/* TestCustomBoxed, a boxed int pygobject knows no marshaller for until
+ * register_custom_boxed_marshaller() is called */
+static gpointer
+test_custom_boxed_copy(gpointer boxed)
+{
+  return g_memdup(boxed, sizeof(gint));
+}
+
+static GType
+test_custom_boxed_get_type(void)
+{
+  static GType gtype = 0;
+
+  if (gtype == 0)
+    gtype = g_boxed_type_register_static("TestCustomBoxed",
+                                         test_custom_boxed_copy, g_free);
+  return gtype;
+}
+
+#define TEST_TYPE_CUSTOM_BOXED (test_custom_boxed_get_type())
+
+static PyObject *
+test_custom_boxed_from_value(const GValue *value)
+{
+  return PYGLIB_PyLong_FromLong(*(gint *)g_value_get_boxed(value));
+}
+
+static int
+test_custom_boxed_to_value(GValue *value, PyObject *obj)
+{
+  gint data;
+
+  if (!PYGLIB_PyLong_Check(obj))
+    return -1;
+
+  data = PYGLIB_PyLong_AsLong(obj);
+  g_value_set_boxed(value, &data);
+  return 0;
+}
+
+static PyObject *
+_wrap_test_custom_boxed_get(PyObject *self, PyObject *args)
+{
+  GValue value = {0,};
+  PyObject *ret;
+  gint data;
+
+  if (!PyArg_ParseTuple(args, "i", &data))
+    return NULL;
+
+  g_value_init(&value, TEST_TYPE_CUSTOM_BOXED);
+  g_value_set_boxed(&value, &data);
+  ret = pyg_value_as_pyobject(&value, TRUE);
+  g_value_unset(&value);
+
+  return ret;
+}
+
+static PyObject *
+_wrap_test_custom_boxed_set(PyObject *self, PyObject *args)
+{
+  GValue value = {0,};
+  PyObject *obj, *ret;
+
+  if (!PyArg_ParseTuple(args, "O", &obj))
+    return NULL;
+
+  g_value_init(&value, TEST_TYPE_CUSTOM_BOXED);
+  if (pyg_value_from_pyobject(&value, obj)) {
+    if (G_IS_VALUE(&value))
+      g_value_unset(&value);
+    PyErr_SetString(PyExc_TypeError, "Could not convert to TestCustomBoxed");
+    return NULL;
+  }
+
+  ret = PYGLIB_PyLong_FromLong(*(gint *)g_value_get_boxed(&value));
+  g_value_unset(&value);
+
+  return ret;
+}
+
+static PyObject *
+_wrap_register_custom_boxed_marshaller(PyObject *self)
+{
+  pyg_register_gtype_custom(TEST_TYPE_CUSTOM_BOXED,
+                            test_custom_boxed_from_value,
+                            test_custom_boxed_to_value);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+typedef struct {
+    GObject *obj;
+    int n;
+} RefUnrefData;
+
+static gpointer
+ref_unref_thread(gpointer data)
+{
+    RefUnrefData *d = data;
+    int i;
+
+    for (i = 0; i < d->n; i++) {
+        g_object_ref(d->obj);
+        g_object_unref(d->obj);
+    }
+    return NULL;
+}
+
+static PyObject *
+_wrap_test_ref_unref_in_thread(PyObject *self, PyObject *args)
+{
+    PyGObject *obj;
+    RefUnrefData data;
+    GThread *thread;
+
+    if (!PyArg_ParseTuple(args, "O!i", _PyGObject_Type, &obj, &data.n))
+      return NULL;
+
+    data.obj = obj->obj;
+    pyg_begin_allow_threads;
+    thread = g_thread_create(ref_unref_thread, &data, TRUE, NULL);
+    g_thread_join(thread);
+    pyg_end_allow_threads;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject *
 _wrap_test_gerror_exception(PyObject *self, PyObject *args)
 {
@@ -516,7 +646,11 @@ static PyMethodDef testhelper_functions[] = {
     { "connectcallbacks", (PyCFunction)_wrap_connectcallbacks, METH_VARARGS },
     { "test_value", (PyCFunction)_wrap_test_value, METH_VARARGS },      
     { "test_value_array", (PyCFunction)_wrap_test_value_array, METH_VARARGS },
+    { "test_custom_boxed_get", (PyCFunction)_wrap_test_custom_boxed_get, METH_VARARGS },
+    { "test_custom_boxed_set", (PyCFunction)_wrap_test_custom_boxed_set, METH_VARARGS },
+    { "register_custom_boxed_marshaller", (PyCFunction)_wrap_register_custom_boxed_marshaller, METH_NOARGS },
     { "test_gerror_exception", (PyCFunction)_wrap_test_gerror_exception, METH_VARARGS },
+    { "test_ref_unref_in_thread", (PyCFunction)_wrap_test_ref_unref_in_thread, METH_VARARGS },
     { "owned_by_library_get_instance_list", (PyCFunction)_wrap_test_owned_by_library_get_instance_list, METH_NOARGS },
     { "floating_and_sunk_get_instance_list", (PyCFunction)_wrap_test_floating_and_sunk_get_instance_list, METH_NOARGS },
     { NULL, NULL }